@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+// Throughput of every AES backend on the host, one JSON object per line:
+//   {"bench":"aes","backend":...,"mode":"block"|"ccm","payload":...,
+//    "bytes_per_second":...}
+// `block` encrypts single blocks, `ccm` protects a payload of the given
+// length like SX127xSecureLink (header as associated data, 4 byte MIC).
+
+#include <chrono>
+#include <stdio.h>
+
+#include "../sx127x_secure.hpp"
+
+using namespace modm;
+using HostClock = std::chrono::steady_clock;
+
+namespace
+{
+
+const uint8_t key[16] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+	0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+// Keeps the compiler from dropping the encryption
+volatile uint8_t sink;
+
+void
+report(const char *backend, const char *mode, uint8_t payload, double bytes, double seconds)
+{
+	printf("{\"bench\":\"aes\",\"backend\":\"%s\",\"mode\":\"%s\",\"payload\":%u,"
+		   "\"bytes_per_second\":%.0f}\n", backend, mode, payload, bytes / seconds);
+}
+
+template <typename Aes>
+void
+measure(const char *backend)
+{
+	constexpr uint32_t Iterations = 200000;
+
+	{
+		Aes aes;
+		aes.setKey(key);
+		uint8_t block[16] = {};
+		const auto start = HostClock::now();
+		for (uint32_t i = 0; i < Iterations; i++) {
+			aes.encrypt(block);
+		}
+		report(backend, "block", 16, 16.0 * Iterations,
+			   std::chrono::duration<double>(HostClock::now() - start).count());
+		sink = block[0];
+	}
+
+	for (uint8_t payload : {16, 64, 246})
+	{
+		SX127xCcm<Aes, 4> ccm;
+		ccm.setKey(key);
+		uint8_t nonce[13] = {}, header[5] = {}, data[246] = {}, mic[4];
+		const uint32_t messages = Iterations * 16 / payload;
+
+		const auto start = HostClock::now();
+		for (uint32_t i = 0; i < messages; i++)
+		{
+			nonce[1] = header[1] = uint8_t(i);
+			ccm.begin(nonce, header, sizeof(header), payload);
+			ccm.encrypt(data, payload);
+			ccm.finish(mic);
+		}
+		report(backend, "ccm", payload, double(messages) * payload,
+			   std::chrono::duration<double>(HostClock::now() - start).count());
+		sink = mic[0];
+	}
+}
+
+}
+
+int
+main()
+{
+	measure<SX127xAesSoftware>("SX127xAesSoftware");
+	measure<SX127xAesTable>("SX127xAesTable");
+	return 0;
+}
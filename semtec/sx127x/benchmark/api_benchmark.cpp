@@ -0,0 +1,145 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+// SPI cost of every public SX127x API and simulated packet rates.
+//
+// Prints one JSON object per line:
+//   {"bench":"api","api":...,"latency":...,"transactions":...,"bytes":...,
+//    "cs_toggles":...,"steps":...,"primitive_steps":...}
+//   {"bench":"loop","loop":"tx"|"rx",...,"packets_per_second":...}
+// `steps` counts the polls of the public API until it finished,
+// `primitive_steps` the polls of the register access primitives. The packet
+// rates are bus bound, the simulated time only advances with the SPI clock
+// and one microsecond per poll; airtime is not modelled.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../sx127x.hpp"
+#include "mock_radio.hpp"
+
+using namespace modm;
+using namespace sx127x_host;
+
+using Radio = SX127x<MockSpiMaster, MockCs, SX127xStatistics>;
+
+namespace
+{
+
+Radio driver;
+uint8_t payload[255];
+
+template <typename Function>
+void
+measure(const char *api, Function &&function)
+{
+	driver.resetStatistics();
+	radio.resetCounters();
+	uint32_t steps = run(function);
+
+	const auto &statistics = driver.getStatistics();
+	if (statistics.transactions != radio.counters.transactions or
+		statistics.bytes != radio.counters.bytes or
+		statistics.csToggles != radio.counters.csToggles)
+	{
+		fprintf(stderr, "%s: driver statistics disagree with the bus\n", api);
+		exit(1);
+	}
+	printf("{\"bench\":\"api\",\"api\":\"%s\",\"latency\":%u,\"transactions\":%u,"
+		   "\"bytes\":%u,\"cs_toggles\":%u,\"steps\":%u,\"primitive_steps\":%u}\n",
+		   api, radio.latency, statistics.transactions, statistics.bytes,
+		   statistics.csToggles, steps, statistics.steps);
+}
+
+void
+apis()
+{
+	measure("initialize", [] { return driver.initialize(); });
+	measure("setLora", [] { return driver.setLora(); });
+	measure("setLowFrequencyMode", [] { return driver.setLowFrequencyMode(); });
+	measure("setHighFrequencyMode", [] { return driver.setHighFrequencyMode(); });
+	measure("setLnaGain", [] { return driver.setLnaGain(1); });
+	measure("setLnaBoostHf", [] { return driver.setLnaBoostHf(); });
+	measure("setAgcAutoOn", [] { return driver.setAgcAutoOn(); });
+	measure("setLowDataRateOptimize", [] { return driver.setLowDataRateOptimize(); });
+	measure("setOperationMode", [] { return driver.setOperationMode(sx127x::Mode::Standby); });
+	measure("setCarrierFreq(msb,mid,lsb)", [] { return driver.setCarrierFreq(0xd9, 0x06, 0x8b); });
+	measure("setCarrierFreq(freq)", [] { return driver.setCarrierFreq(868100000); });
+	measure("setPaBoost", [] { return driver.setPaBoost(); });
+	measure("setOutputPower", [] { return driver.setOutputPower(14); });
+	measure("setBandwidth", [] { return driver.setBandwidth(sx127x::SignalBandwidth::Fr125kHz); });
+	measure("setCodingRate", [] { return driver.setCodingRate(sx127x::ErrorCodingRate::Cr4_5); });
+	measure("setSpreadingFactor", [] { return driver.setSpreadingFactor(sx127x::SpreadingFactor::SF7); });
+	measure("setImplicitHeaderMode", [] { return driver.setImplicitHeaderMode(); });
+	measure("setExplicitHeaderMode", [] { return driver.setExplicitHeaderMode(); });
+	measure("setDio0Mapping", [] { return driver.setDio0Mapping(1); });
+	measure("enablePayloadCRC", [] { return driver.enablePayloadCRC(); });
+	measure("setPayloadLength", [] { return driver.setPayloadLength(32); });
+	measure("getInterrupt", [] { return driver.getInterrupt(sx127x::RegIrqFlags::TxDone); });
+	measure("sendPacket(32)", [] { return driver.sendPacket(payload, 32); });
+	measure("loadPacket(32)", [] { return driver.loadPacket(payload, 32); });
+	measure("startTransmit", [] { return driver.startTransmit(); });
+	radio.receive(payload, 32);
+	measure("getPayload(32)", [] { return driver.getPayload(payload, 32); });
+}
+
+void
+loop(const char *name, bool tx, uint32_t packets)
+{
+	driver.resetStatistics();
+	radio.resetCounters();
+	uint64_t start = modm_host::microseconds;
+	uint32_t steps = 0;
+
+	for (uint32_t i = 0; i < packets; i++)
+	{
+		if (tx) {
+			steps += run([] { return driver.sendPacket(payload, 32); });
+		} else {
+			radio.receive(payload, 32);
+		}
+		const auto irq = tx ? sx127x::RegIrqFlags::TxDone : sx127x::RegIrqFlags::RxDone;
+		bool done = false;
+		while (not done) {
+			steps++;
+			auto r = driver.getInterrupt(irq);
+			done = r.getState() == rf::Stop and r.getResult();
+			modm_host::advance(1);
+		}
+		if (not tx) {
+			steps += run([] { return driver.getPayload(payload, 32); });
+		}
+	}
+
+	double seconds = double(modm_host::microseconds - start) / 1e6;
+	const auto &statistics = driver.getStatistics();
+	printf("{\"bench\":\"loop\",\"loop\":\"%s\",\"latency\":%u,\"packets\":%u,"
+		   "\"payload\":32,\"transactions\":%u,\"bytes\":%u,\"steps\":%u,"
+		   "\"simulated_us\":%.0f,\"packets_per_second\":%.1f}\n",
+		   name, radio.latency, packets, statistics.transactions, statistics.bytes,
+		   steps, seconds * 1e6, packets / seconds);
+}
+
+}
+
+int
+main(int argc, char **argv)
+{
+	uint32_t packets = argc > 1 ? uint32_t(atoi(argv[1])) : 1000;
+	for (uint8_t i = 0; i < 32; i++) {
+		payload[i] = i;
+	}
+
+	for (uint8_t latency : {0, 4})
+	{
+		radio.reset();
+		radio.latency = latency;
+		apis();
+		loop("tx", true, packets);
+		loop("rx", false, packets);
+	}
+	return 0;
+}
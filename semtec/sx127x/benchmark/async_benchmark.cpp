@@ -0,0 +1,112 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+// Coroutine front-end against the resumable driver, one JSON object per line:
+//   {"bench":"async","api":...,"latency":...,"resumable_steps":...,
+//    "task_steps":...,"resumable_entries":...,"task_entries":...,
+//    "frame_bytes":...,"frame_blocks":...}
+//   {"bench":"async_ram","path":"resumable"|"coroutine",...,"bytes":...}
+// Steps count the polls until the operation finished, entries the resumable
+// functions entered on the way. A resumable operation is re-entered from the
+// top on every poll, a task resumes at the access primitive it waits for.
+// The resumable path keeps its state in the driver object, the coroutine
+// path additionally needs the frame pool, which is sized for all tasks
+// alive at once.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../sx127x.hpp"
+#include "../sx127x_async.hpp"
+#include "mock_radio.hpp"
+
+using namespace modm;
+using namespace sx127x_host;
+
+using Radio = SX127x<MockSpiMaster, MockCs>;
+
+namespace
+{
+
+Radio driver;
+SX127xAsync async(driver);
+uint8_t payload[255];
+
+template <typename Resumable, typename Task>
+void
+measure(const char *api, Resumable &&resumable, Task &&task)
+{
+	rf::entries = 0;
+	const uint32_t resumableSteps = run(resumable);
+	const uint32_t resumableEntries = rf::entries;
+
+	SX127xFramePool::resetStatistics();
+	rf::entries = 0;
+	uint32_t taskSteps = 0;
+	{
+		auto t = task();
+		if (not t.isValid()) {
+			fprintf(stderr, "%s: no frame\n", api);
+			exit(1);
+		}
+		while (taskSteps++, t.update()) {
+			modm_host::advance(1);
+		}
+	}
+	printf("{\"bench\":\"async\",\"api\":\"%s\",\"latency\":%u,\"resumable_steps\":%u,"
+		   "\"task_steps\":%u,\"resumable_entries\":%u,\"task_entries\":%u,"
+		   "\"frame_bytes\":%zu,\"frame_blocks\":%u}\n",
+		   api, radio.latency, resumableSteps, taskSteps, resumableEntries, rf::entries,
+		   SX127xFramePool::getLargestFrame(), SX127xFramePool::getPeak());
+}
+
+#define MEASURE(api, ...) \
+	measure(api, [] { return driver.__VA_ARGS__; }, [] { return async.__VA_ARGS__; })
+
+void
+apis()
+{
+	MEASURE("initialize", initialize());
+	MEASURE("setLora", setLora());
+	MEASURE("setOperationMode", setOperationMode(sx127x::Mode::Standby));
+	MEASURE("setCarrierFreq(msb,mid,lsb)", setCarrierFreq(0xd9, 0x06, 0x66));
+	MEASURE("setCarrierFreq(freq)", setCarrierFreq(868100000));
+	MEASURE("setBandwidth", setBandwidth(sx127x::SignalBandwidth::Fr125kHz));
+	MEASURE("setSpreadingFactor", setSpreadingFactor(sx127x::SpreadingFactor::SF7));
+	MEASURE("setPayloadLength", setPayloadLength(32));
+	MEASURE("getInterrupt", getInterrupt(sx127x::RegIrqFlags::TxDone));
+	MEASURE("sendPacket(32)", sendPacket(payload, 32));
+	radio.receive(payload, 32);
+	MEASURE("getPayload(32)", getPayload(payload, 32));
+}
+
+void
+ram()
+{
+	printf("{\"bench\":\"async_ram\",\"path\":\"resumable\",\"object\":\"SX127x\",\"bytes\":%zu}\n",
+		   sizeof(Radio));
+	printf("{\"bench\":\"async_ram\",\"path\":\"coroutine\",\"object\":\"SX127x+SX127xAsync\","
+		   "\"bytes\":%zu}\n", sizeof(Radio) + sizeof(SX127xAsync));
+	printf("{\"bench\":\"async_ram\",\"path\":\"coroutine\",\"object\":\"SX127xFramePool::storage\","
+		   "\"blocks\":%u,\"block_size\":%zu,\"bytes\":%zu}\n",
+		   SX127xFramePool::Blocks, SX127xFramePool::BlockSize,
+		   SX127xFramePool::Blocks * SX127xFramePool::BlockSize);
+}
+
+}
+
+int
+main()
+{
+	for (uint8_t latency : {0, 4})
+	{
+		radio.reset();
+		radio.latency = latency;
+		apis();
+	}
+	ram();
+	return 0;
+}
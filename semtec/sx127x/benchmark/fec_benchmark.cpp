@@ -0,0 +1,74 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+// Encode and decode throughput of SX127xFecCodec on the host, one JSON
+// object per line:
+//   {"bench":"fec","k":...,"m":...,"size":...,"encode_bytes_per_second":...,
+//    "decode_bytes_per_second":...}
+// Decoding restores min(k, m) lost data fragments, its worst case.
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+#include "../sx127x_fec.hpp"
+
+using namespace modm;
+using HostClock = std::chrono::steady_clock;
+
+namespace
+{
+
+uint8_t fragments[32 * 253];
+uint8_t work[32 * 253];
+uint8_t matrix[32 * 32];
+
+void
+measure(uint8_t k, uint8_t m, uint16_t size)
+{
+	for (uint16_t i = 0; i < k * size; i++) {
+		fragments[i] = uint8_t(i * 7 + 3);
+	}
+	const uint8_t lost = k < m ? k : m;
+	const uint32_t present = ((1ul << (k + m)) - 1) & ~((1ul << lost) - 1);
+	const uint32_t iterations = 2000000 / (k * size) + 1;
+
+	auto start = HostClock::now();
+	for (uint32_t i = 0; i < iterations; i++) {
+		SX127xFecCodec::encode(fragments, k, m, size);
+	}
+	const double encode = std::chrono::duration<double>(HostClock::now() - start).count();
+
+	start = HostClock::now();
+	for (uint32_t i = 0; i < iterations; i++) {
+		memcpy(work, fragments, (k + m) * size);
+		memset(work, 0, lost * size);
+		SX127xFecCodec::decode(work, present, k, m, size, matrix);
+	}
+	const double decode = std::chrono::duration<double>(HostClock::now() - start).count();
+
+	if (memcmp(work, fragments, k * size) != 0) {
+		fprintf(stderr, "fec: decoding failed\n");
+	}
+
+	const double bytes = double(iterations) * k * size;
+	printf("{\"bench\":\"fec\",\"k\":%u,\"m\":%u,\"size\":%u,\"lost\":%u,"
+		   "\"encode_bytes_per_second\":%.0f,\"decode_bytes_per_second\":%.0f}\n",
+		   k, m, size, lost, bytes / encode, bytes / decode);
+}
+
+}
+
+int
+main()
+{
+	measure(4, 2, 64);
+	measure(8, 4, 32);
+	measure(8, 4, 253);
+	measure(16, 8, 128);
+	measure(24, 8, 253);
+	return 0;
+}
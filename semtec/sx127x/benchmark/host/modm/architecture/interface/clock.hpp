@@ -0,0 +1,61 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+// Host replacement of the modm clocks, driven by a simulated time that the
+// mock bus and the benchmarks advance explicitly. Like on the target both
+// clocks count in uint32_t and wrap around, after 49.7 days respectively
+// 71.6 minutes.
+
+#ifndef MODM_HOST_CLOCK_HPP
+#define MODM_HOST_CLOCK_HPP
+
+#include <chrono>
+#include <stdint.h>
+
+namespace modm_host
+{
+
+/// Simulated time since start in microseconds
+inline uint64_t microseconds = 0;
+
+inline void
+advance(uint64_t us)
+{ microseconds += us; }
+
+}
+
+namespace modm
+{
+
+struct Clock
+{
+	using duration = std::chrono::duration<uint32_t, std::milli>;
+	using rep = duration::rep;
+	using period = duration::period;
+	using time_point = std::chrono::time_point<Clock, duration>;
+	static constexpr bool is_steady = true;
+
+	static time_point
+	now()
+	{ return time_point(duration(static_cast<uint32_t>(modm_host::microseconds / 1000))); }
+};
+
+struct PreciseClock
+{
+	using duration = std::chrono::duration<uint32_t, std::micro>;
+	using rep = duration::rep;
+	using period = duration::period;
+	using time_point = std::chrono::time_point<PreciseClock, duration>;
+	static constexpr bool is_steady = true;
+
+	static time_point
+	now()
+	{ return time_point(duration(static_cast<uint32_t>(modm_host::microseconds))); }
+};
+
+}
+
+#endif
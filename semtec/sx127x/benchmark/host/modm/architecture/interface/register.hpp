@@ -0,0 +1,66 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+// Host replacement of the parts of the modm register API used by the driver
+
+#ifndef MODM_HOST_REGISTER_HPP
+#define MODM_HOST_REGISTER_HPP
+
+#include <stdint.h>
+
+namespace modm
+{
+
+template <typename Enum>
+struct Flags8
+{
+	uint8_t value;
+
+	constexpr Flags8() : value(0) {}
+	constexpr Flags8(Enum flag) : value(static_cast<uint8_t>(flag)) {}
+	explicit constexpr Flags8(uint8_t value) : value(value) {}
+
+	void set(Enum flag) { value |= static_cast<uint8_t>(flag); }
+	void reset(Enum flag) { value &= ~static_cast<uint8_t>(flag); }
+
+	constexpr Flags8 operator & (Enum flag) const { return Flags8(static_cast<uint8_t>(value & static_cast<uint8_t>(flag))); }
+	constexpr Flags8 operator | (Enum flag) const { return Flags8(static_cast<uint8_t>(value | static_cast<uint8_t>(flag))); }
+	constexpr operator bool () const { return value != 0; }
+};
+
+template <typename Parent, typename Enum, uint8_t Mask, uint8_t Position = 0>
+struct Configuration
+{
+	static void set(Parent &parent, Enum config)
+	{
+		parent.value = (parent.value & ~(Mask << Position)) |
+				((static_cast<uint8_t>(config) & Mask) << Position);
+	}
+
+	static Enum get(Parent parent)
+	{ return static_cast<Enum>((parent.value >> Position) & Mask); }
+};
+
+template <typename Parent, uint8_t Width, uint8_t Position = 0>
+struct Value
+{
+	static constexpr uint8_t Mask = (1u << Width) - 1;
+
+	static void set(Parent &parent, uint8_t value)
+	{ parent.value = (parent.value & ~(Mask << Position)) | ((value & Mask) << Position); }
+
+	static uint8_t get(Parent parent)
+	{ return (parent.value >> Position) & Mask; }
+};
+
+}
+
+#define MODM_FLAGS8(Enum) \
+	typedef ::modm::Flags8<Enum> Enum ## _t; \
+	friend constexpr Enum ## _t operator | (Enum a, Enum b) \
+	{ return Enum ## _t(static_cast<uint8_t>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b))); }
+
+#endif
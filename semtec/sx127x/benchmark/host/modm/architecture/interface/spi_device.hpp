@@ -0,0 +1,26 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef MODM_HOST_SPI_DEVICE_HPP
+#define MODM_HOST_SPI_DEVICE_HPP
+
+#include <modm/processing/resumable.hpp>
+
+namespace modm
+{
+
+/// Host replacement, the bus is never shared
+template <typename SpiMaster>
+class SpiDevice
+{
+protected:
+	bool acquireMaster() { return true; }
+	bool releaseMaster() { return true; }
+};
+
+}
+
+#endif
@@ -0,0 +1,12 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef MODM_HOST_UTILS_HPP
+#define MODM_HOST_UTILS_HPP
+
+#define modm_packed __attribute__((packed))
+
+#endif
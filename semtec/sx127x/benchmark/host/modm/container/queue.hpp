@@ -0,0 +1,54 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef MODM_HOST_QUEUE_HPP
+#define MODM_HOST_QUEUE_HPP
+
+#include <stddef.h>
+
+namespace modm
+{
+
+/// Host replacement of modm::BoundedQueue
+template <typename T, size_t N>
+class BoundedQueue
+{
+public:
+	bool isEmpty() const { return size == 0; }
+	bool isFull() const { return size == N; }
+	size_t getSize() const { return size; }
+	static constexpr size_t getMaxSize() { return N; }
+
+	T& get() { return values[head]; }
+	const T& get() const { return values[head]; }
+
+	bool
+	push(const T &value)
+	{
+		if (isFull()) {
+			return false;
+		}
+		values[(head + size) % N] = value;
+		size++;
+		return true;
+	}
+
+	void
+	pop()
+	{
+		head = (head + 1) % N;
+		size--;
+	}
+
+private:
+	T values[N];
+	size_t head = 0;
+	size_t size = 0;
+};
+
+}
+
+#endif
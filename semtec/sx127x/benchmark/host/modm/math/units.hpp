@@ -0,0 +1,26 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef MODM_HOST_UNITS_HPP
+#define MODM_HOST_UNITS_HPP
+
+#include <stdint.h>
+
+namespace modm
+{
+
+using frequency_t = uint32_t;
+
+namespace literals
+{
+	constexpr frequency_t operator ""_MHz(unsigned long long value) { return value * 1000000; }
+	constexpr frequency_t operator ""_kHz(unsigned long long value) { return value * 1000; }
+}
+using namespace literals;
+
+}
+
+#endif
@@ -0,0 +1,21 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef MODM_HOST_BIT_CONSTANTS_HPP
+#define MODM_HOST_BIT_CONSTANTS_HPP
+
+namespace modm
+{
+
+enum : unsigned
+{
+	Bit0 = 1u << 0, Bit1 = 1u << 1, Bit2 = 1u << 2, Bit3 = 1u << 3,
+	Bit4 = 1u << 4, Bit5 = 1u << 5, Bit6 = 1u << 6, Bit7 = 1u << 7
+};
+
+}
+
+#endif
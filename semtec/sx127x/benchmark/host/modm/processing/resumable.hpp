@@ -0,0 +1,126 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+// Host replacement of the modm resumable functions. The state of every
+// nesting level is kept like in modm, so the step counts measured on the
+// host match the target.
+
+#ifndef MODM_HOST_RESUMABLE_HPP
+#define MODM_HOST_RESUMABLE_HPP
+
+#include <stdint.h>
+
+namespace modm
+{
+
+namespace rf
+{
+
+enum : uint8_t
+{
+	Stop = 0,
+	NestingError = (1 << 0),
+	Running = (1 << 1)
+};
+
+/// Number of times a resumable function has been entered, host only
+inline uint32_t entries = 0;
+
+/// Marks a nesting level as used while a resumable function executes
+class LevelGuard
+{
+public:
+	explicit LevelGuard(int8_t &level) : level(level) { level++; entries++; }
+	~LevelGuard() { level--; }
+
+private:
+	int8_t &level;
+};
+
+}
+
+template <typename T>
+class ResumableResult
+{
+public:
+	ResumableResult(uint8_t state) : state(state), result() {}
+	ResumableResult(uint8_t state, T result) : state(state), result(result) {}
+
+	uint8_t getState() const { return state; }
+	T getResult() const { return result; }
+
+private:
+	uint8_t state;
+	T result;
+};
+
+template <>
+class ResumableResult<void>
+{
+public:
+	ResumableResult(uint8_t state) : state(state) {}
+
+	uint8_t getState() const { return state; }
+	void getResult() const {}
+
+private:
+	uint8_t state;
+};
+
+template <uint8_t Levels = 1>
+class NestedResumable
+{
+protected:
+	static constexpr int8_t rfLevels = Levels;
+
+	int8_t rfLevel = 0;
+	uint16_t rfStateArray[Levels] = {};
+};
+
+}
+
+#define RF_BEGIN() \
+	if (this->rfLevel >= this->rfLevels) { return {::modm::rf::NestingError}; } \
+	::modm::rf::LevelGuard rfGuard(this->rfLevel); \
+	uint16_t &rfState = this->rfStateArray[this->rfLevel - 1]; \
+	switch (rfState) { case 0:
+
+#define RF_END() \
+	} rfState = 0; return {::modm::rf::Stop}
+
+#define RF_END_RETURN(value) \
+	} rfState = 0; return {::modm::rf::Stop, value}
+
+#define RF_RETURN(...) \
+	do { rfState = 0; return {::modm::rf::Stop, ##__VA_ARGS__}; } while (0)
+
+#define RF_INTERNAL_YIELD(n) \
+	do { rfState = (n); return {::modm::rf::Running}; case (n): ; } while (0)
+#define RF_YIELD() RF_INTERNAL_YIELD(__COUNTER__ + 1)
+
+#define RF_INTERNAL_WAIT_UNTIL(condition, n) \
+	do { rfState = (n); [[fallthrough]]; case (n): \
+		if (not (condition)) { return {::modm::rf::Running}; } } while (0)
+#define RF_WAIT_UNTIL(condition) RF_INTERNAL_WAIT_UNTIL(condition, __COUNTER__ + 1)
+#define RF_WAIT_WHILE(condition) RF_INTERNAL_WAIT_UNTIL(not (condition), __COUNTER__ + 1)
+
+#define RF_INTERNAL_CALL(resumable, n) \
+	({ \
+		rfState = (n); [[fallthrough]]; case (n): ; \
+		auto rfResult = resumable; \
+		if (rfResult.getState() > ::modm::rf::NestingError) { return {::modm::rf::Running}; } \
+		rfResult.getResult(); \
+	})
+#define RF_CALL(resumable) RF_INTERNAL_CALL(resumable, __COUNTER__ + 1)
+
+#define RF_CALL_BLOCKING(resumable) \
+	({ \
+		auto rfResult = resumable; \
+		while (rfResult.getState() > ::modm::rf::NestingError) { rfResult = resumable; } \
+		rfResult.getResult(); \
+	})
+
+#endif
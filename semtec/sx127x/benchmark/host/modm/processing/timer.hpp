@@ -0,0 +1,58 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef MODM_HOST_TIMER_HPP
+#define MODM_HOST_TIMER_HPP
+
+#include <modm/architecture/interface/clock.hpp>
+
+namespace modm
+{
+
+template <typename ClockType>
+class HostTimeout
+{
+public:
+	HostTimeout() = default;
+
+	explicit HostTimeout(typename ClockType::duration interval)
+	{ restart(interval); }
+
+	void
+	restart(typename ClockType::duration interval)
+	{
+		start = ClockType::now();
+		this->interval = interval;
+		armed = true;
+	}
+
+	void
+	stop()
+	{ armed = false; }
+
+	// Elapsed time instead of a deadline, so the clock may wrap around
+	bool
+	isArmed() const
+	{ return armed and ClockType::now() - start < interval; }
+
+	bool
+	isExpired() const
+	{ return armed and ClockType::now() - start >= interval; }
+
+private:
+	typename ClockType::time_point start = {};
+	typename ClockType::duration interval = {};
+	bool armed = false;
+};
+
+using ShortTimeout = HostTimeout<Clock>;
+using Timeout = HostTimeout<Clock>;
+using ShortPreciseTimeout = HostTimeout<PreciseClock>;
+using PreciseTimeout = HostTimeout<PreciseClock>;
+
+}
+
+#endif
@@ -0,0 +1,355 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef SX127X_MOCK_RADIO_HPP
+#define SX127X_MOCK_RADIO_HPP
+
+#include <stdint.h>
+#include <string.h>
+
+#include <modm/architecture/interface/clock.hpp>
+#include <modm/processing/resumable.hpp>
+
+#include "../sx127x_definitions.hpp"
+
+namespace sx127x_host
+{
+
+using Address = modm::sx127x::Address;
+
+/**
+ *  Register level model of a SX127x in LoRa mode.
+ *
+ *  Models what the driver relies on: the Fifo with its address pointer,
+ *  burst access with auto-incremented addresses, write-1-to-clear IrqFlags,
+ *  the automatic return to Standby after TxDone and RxSingle, and packet
+ *  reception. Like on the chip the Fifo can only be filled in Standby,
+ *  other writes are dropped and counted in fifoWriteErrors. Every bus
+ *  transaction and byte is counted independently of the driver statistics.
+ */
+class MockRadio
+{
+public:
+	static constexpr uint8_t OpModeMask = 0x07;
+	static constexpr uint8_t Standby = 0x01;
+	static constexpr uint8_t Transmit = 0x03;
+	static constexpr uint8_t RecvSingle = 0x06;
+	static constexpr uint8_t Cad = 0x07;
+
+	static constexpr uint8_t RxTimeout = 0x80;
+	static constexpr uint8_t RxDone = 0x40;
+	static constexpr uint8_t TxDone = 0x08;
+	static constexpr uint8_t CadDone = 0x04;
+
+	struct Counters
+	{
+		uint32_t transactions;
+		uint32_t bytes;
+		uint32_t csToggles;
+	};
+
+	uint8_t reg[128];
+	uint8_t fifo[256];
+	Counters counters;
+	/// Fifo writes outside Standby, which the chip ignores
+	uint32_t fifoWriteErrors;
+
+	/// Simulated SCK period in nanoseconds per byte (8 MHz)
+	uint32_t byteTimeNs = 1000;
+	/// Polls a SpiMaster transfer stays pending before it completes
+	uint8_t latency = 0;
+	/// Whether Transmit completes immediately, else call finishTransmit()
+	bool instantTx = true;
+	/// Live RSSI of the tuned channel, RssiValue reads 0 if not set
+	uint8_t (*rssi)(uint32_t frf) = nullptr;
+
+	MockRadio() { reset(); }
+
+	void
+	reset()
+	{
+		memset(reg, 0, sizeof(reg));
+		memset(fifo, 0, sizeof(fifo));
+		reg[uint8_t(Address::OpMode)] = 0x09;
+		reg[uint8_t(Address::FrMsb)] = 0x6c;
+		reg[uint8_t(Address::FrMid)] = 0x80;
+		reg[uint8_t(Address::PaConfig)] = 0x4f;
+		reg[uint8_t(Address::Lna)] = 0x20;
+		reg[uint8_t(Address::FifoTxBaseAddr)] = 0x80;
+		reg[uint8_t(Address::ModemConfig1)] = 0x72;
+		reg[uint8_t(Address::ModemConfig2)] = 0x70;
+		reg[uint8_t(Address::PayloadLength)] = 0x01;
+		reg[uint8_t(Address::SyncWord)] = 0x12;
+		resetCounters();
+		fifoWriteErrors = 0;
+		rssi = nullptr;
+		selected = false;
+		pendingNs = 0;
+	}
+
+	void
+	resetCounters()
+	{ counters = Counters(); }
+
+	uint8_t
+	mode() const
+	{ return reg[uint8_t(Address::OpMode)] & OpModeMask; }
+
+	uint32_t
+	frf() const
+	{
+		return (uint32_t(reg[uint8_t(Address::FrMsb)]) << 16) |
+				(uint32_t(reg[uint8_t(Address::FrMid)]) << 8) |
+				reg[uint8_t(Address::FrLsb)];
+	}
+
+	/// Last packet handed to the modem for transmission
+	const uint8_t*
+	lastTx(uint8_t &length) const
+	{
+		length = txLength;
+		return txData;
+	}
+
+	/// Completes a pending transmission when instantTx is disabled
+	void
+	finishTransmit()
+	{
+		if (mode() == Transmit) {
+			txDone();
+		}
+	}
+
+	/// Places a packet in the Fifo as if received over the air
+	void
+	receive(const uint8_t *data, uint8_t length, int8_t snr = 40, uint8_t rssi = 60)
+	{
+		uint8_t base = reg[uint8_t(Address::FifoRxBaseAddr)];
+		for (uint8_t i = 0; i < length; i++) {
+			fifo[uint8_t(base + i)] = data[i];
+		}
+		reg[uint8_t(Address::FifoRxCurrAddr)] = base;
+		reg[uint8_t(Address::RxNbBytes)] = length;
+		reg[uint8_t(Address::RegPktSnrValue)] = uint8_t(snr);
+		reg[uint8_t(Address::RegPktRssiValue)] = rssi;
+		reg[uint8_t(Address::IrqFlags)] |= RxDone;
+		if (mode() == RecvSingle) {
+			setMode(Standby);
+		}
+	}
+
+	/// Ends a RxSingle window without a packet
+	void
+	receiveTimeout()
+	{
+		reg[uint8_t(Address::IrqFlags)] |= RxTimeout;
+		if (mode() == RecvSingle) {
+			setMode(Standby);
+		}
+	}
+
+	// -- Bus ------------------------------------------------------------------
+
+	void
+	select()
+	{
+		selected = true;
+		first = true;
+		counters.transactions++;
+		counters.csToggles++;
+	}
+
+	void
+	deselect()
+	{
+		selected = false;
+		counters.csToggles++;
+	}
+
+	uint8_t
+	exchange(uint8_t tx)
+	{
+		counters.bytes++;
+		pendingNs += byteTimeNs;
+		modm_host::advance(pendingNs / 1000);
+		pendingNs %= 1000;
+
+		if (not selected) {
+			return 0;
+		}
+		if (first) {
+			first = false;
+			writeAccess = tx & 0x80;
+			address = tx & 0x7f;
+			return 0;
+		}
+		uint8_t rx = 0;
+		if (writeAccess) {
+			writeRegister(address, tx);
+		} else {
+			rx = readRegister(address);
+		}
+		if (address != uint8_t(Address::Fifo)) {
+			address = (address + 1) & 0x7f;
+		}
+		return rx;
+	}
+
+private:
+	void
+	setMode(uint8_t mode)
+	{
+		uint8_t &opMode = reg[uint8_t(Address::OpMode)];
+		opMode = (opMode & ~OpModeMask) | mode;
+	}
+
+	void
+	txDone()
+	{
+		txLength = reg[uint8_t(Address::PayloadLength)];
+		uint8_t base = reg[uint8_t(Address::FifoTxBaseAddr)];
+		for (uint8_t i = 0; i < txLength; i++) {
+			txData[i] = fifo[uint8_t(base + i)];
+		}
+		reg[uint8_t(Address::IrqFlags)] |= TxDone;
+		setMode(Standby);
+	}
+
+	void
+	writeRegister(uint8_t address, uint8_t value)
+	{
+		switch (address)
+		{
+			case uint8_t(Address::Fifo):
+				if (mode() != Standby) {
+					fifoWriteErrors++;
+					break;
+				}
+				fifo[reg[uint8_t(Address::FifoAddrPtr)]++] = value;
+				break;
+			case uint8_t(Address::IrqFlags):
+				reg[address] &= ~value;
+				break;
+			case uint8_t(Address::OpMode):
+				if ((value & OpModeMask) == 0x00) {
+					// The Fifo is not retained in Sleep mode
+					memset(fifo, 0, sizeof(fifo));
+				}
+				reg[address] = value;
+				if ((value & OpModeMask) == Transmit and instantTx) {
+					txDone();
+				} else if ((value & OpModeMask) == Cad) {
+					reg[uint8_t(Address::IrqFlags)] |= CadDone;
+					setMode(Standby);
+				}
+				break;
+			default:
+				reg[address] = value;
+				break;
+		}
+	}
+
+	uint8_t
+	readRegister(uint8_t address)
+	{
+		if (address == uint8_t(Address::Fifo)) {
+			return fifo[reg[uint8_t(Address::FifoAddrPtr)]++];
+		}
+		if (address == uint8_t(Address::RssiValue)) {
+			return rssi ? rssi(frf()) : 0;
+		}
+		return reg[address];
+	}
+
+	bool selected;
+	bool first;
+	bool writeAccess;
+	uint8_t address;
+	uint32_t pendingNs;
+	uint8_t txData[256];
+	uint8_t txLength = 0;
+};
+
+inline MockRadio radio;
+
+/// SpiMaster with a configurable number of pending polls per transfer
+struct MockSpiMaster
+{
+	enum class DataMode { Mode0, Mode1, Mode2, Mode3 };
+	enum class DataOrder { MsbFirst, LsbFirst };
+
+	static inline uint8_t polls = 0;
+
+	static void setDataMode(DataMode) {}
+	static void setDataOrder(DataOrder) {}
+
+	static modm::ResumableResult<uint8_t>
+	transfer(uint8_t data)
+	{
+		if (polls < radio.latency) {
+			polls++;
+			return {modm::rf::Running};
+		}
+		polls = 0;
+		return {modm::rf::Stop, radio.exchange(data)};
+	}
+
+	static modm::ResumableResult<void>
+	transfer(const uint8_t *tx, uint8_t *rx, size_t length)
+	{
+		if (polls < radio.latency) {
+			polls++;
+			return {modm::rf::Running};
+		}
+		polls = 0;
+		for (size_t i = 0; i < length; i++) {
+			uint8_t value = radio.exchange(tx ? tx[i] : 0);
+			if (rx) {
+				rx[i] = value;
+			}
+		}
+		return {modm::rf::Stop};
+	}
+};
+
+struct MockCs
+{
+	static void reset() { radio.select(); }
+	static void set() { radio.deselect(); }
+};
+
+/// Polls a resumable function until it finished, returns the number of polls
+template <typename Function>
+uint32_t
+run(Function &&function, uint32_t limit = 1000000)
+{
+	uint32_t steps = 0;
+	while (steps < limit) {
+		steps++;
+		if (function().getState() <= modm::rf::NestingError) {
+			break;
+		}
+		modm_host::advance(1);
+	}
+	return steps;
+}
+
+/// Same as run() for functions with a result
+template <typename Function>
+auto
+result(Function &&function, uint32_t limit = 1000000)
+{
+	auto r = function();
+	for (uint32_t steps = 1; r.getState() > modm::rf::NestingError and steps < limit; steps++) {
+		modm_host::advance(1);
+		r = function();
+	}
+	return r.getResult();
+}
+
+}
+
+#endif
@@ -0,0 +1,47 @@
+# Prints the driver code size of the size_radios binaries as JSON lines:
+#   {"bench":"flash","radios":N,"bytes":...}
+#   {"bench":"flash","metric":"core","bytes":...}
+#   {"bench":"flash","metric":"per_instantiation","bytes":...}
+# Only symbols of namespace modm are counted, so the C/C++ runtime and the
+# mock bus do not distort the result.
+#
+#   cmake -DNM=nm -DBINARIES="size0|size1|size2" -P size.cmake
+
+cmake_minimum_required(VERSION 3.16)
+string(REPLACE "|" ";" BINARIES "${BINARIES}")
+set(index 0)
+foreach(binary ${BINARIES})
+    execute_process(COMMAND ${NM} -C -S --size-sort ${binary}
+                    OUTPUT_VARIABLE symbols RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "${NM} failed on ${binary}")
+    endif()
+
+    set(bytes 0)
+    # Brackets, e.g. "[clone .cold]", would break the list splitting
+    string(REPLACE "[" "(" symbols "${symbols}")
+    string(REPLACE "]" ")" symbols "${symbols}")
+    string(REPLACE "\n" ";" symbols "${symbols}")
+    foreach(symbol ${symbols})
+        # <address> <size> <type> <name>, text and read-only data only
+        if(symbol MATCHES "^[0-9a-f]+ ([0-9a-f]+) [tTrRvVwW] (.*)$")
+            set(size "${CMAKE_MATCH_1}")
+            set(name "${CMAKE_MATCH_2}")
+            if(name MATCHES "modm::" AND NOT name MATCHES "sx127x_host::")
+                math(EXPR bytes "${bytes} + 0x${size}")
+            endif()
+        endif()
+    endforeach()
+
+    execute_process(COMMAND ${CMAKE_COMMAND} -E echo
+                    "{\"bench\":\"flash\",\"radios\":${index},\"bytes\":${bytes}}")
+    set(flash_${index} ${bytes})
+    math(EXPR index "${index} + 1")
+endforeach()
+
+math(EXPR core "${flash_1} - ${flash_0}")
+math(EXPR instantiation "${flash_2} - ${flash_1}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E echo
+                "{\"bench\":\"flash\",\"metric\":\"core\",\"bytes\":${core}}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E echo
+                "{\"bench\":\"flash\",\"metric\":\"per_instantiation\",\"bytes\":${instantiation}}")
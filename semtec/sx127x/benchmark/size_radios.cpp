@@ -0,0 +1,76 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+// Links RADIOS distinct SX127x instantiations that use every public API.
+// size.cmake compares the driver code of 0, 1 and 2 radios.
+
+#include "../sx127x.hpp"
+#include "mock_radio.hpp"
+
+using namespace modm;
+
+namespace
+{
+
+template <int N>
+struct Spi : sx127x_host::MockSpiMaster {};
+
+template <int N>
+struct Cs : sx127x_host::MockCs {};
+
+[[maybe_unused]] void
+exercise(SX127xCore &radio)
+{
+    uint8_t data[8] = {};
+    RF_CALL_BLOCKING(radio.initialize());
+    RF_CALL_BLOCKING(radio.setLora());
+    RF_CALL_BLOCKING(radio.setLowFrequencyMode());
+    RF_CALL_BLOCKING(radio.setHighFrequencyMode());
+    RF_CALL_BLOCKING(radio.setLnaGain(1));
+    RF_CALL_BLOCKING(radio.setLnaBoostHf());
+    RF_CALL_BLOCKING(radio.setAgcAutoOn());
+    RF_CALL_BLOCKING(radio.setLowDataRateOptimize());
+    RF_CALL_BLOCKING(radio.setOperationMode(sx127x::Mode::Standby));
+    RF_CALL_BLOCKING(radio.writeOpMode(sx127x::RegOpMode_t()));
+    RF_CALL_BLOCKING(radio.setCarrierFreq(0xd9, 0x06, 0x66));
+    RF_CALL_BLOCKING(radio.setCarrierFreq(868100000));
+    RF_CALL_BLOCKING(radio.setPaBoost());
+    RF_CALL_BLOCKING(radio.setOutputPower(14));
+    RF_CALL_BLOCKING(radio.setBandwidth(sx127x::SignalBandwidth::Fr125kHz));
+    RF_CALL_BLOCKING(radio.setCodingRate(sx127x::ErrorCodingRate::Cr4_5));
+    RF_CALL_BLOCKING(radio.setSpreadingFactor(sx127x::SpreadingFactor::SF7));
+    RF_CALL_BLOCKING(radio.setImplicitHeaderMode());
+    RF_CALL_BLOCKING(radio.setExplicitHeaderMode());
+    RF_CALL_BLOCKING(radio.setDio0Mapping(1));
+    RF_CALL_BLOCKING(radio.enablePayloadCRC());
+    RF_CALL_BLOCKING(radio.setPayloadLength(8));
+    RF_CALL_BLOCKING(radio.getInterrupt(sx127x::RegIrqFlags::TxDone));
+    RF_CALL_BLOCKING(radio.getPayload(data, sizeof(data)));
+    RF_CALL_BLOCKING(radio.sendPacket(data, sizeof(data)));
+    RF_CALL_BLOCKING(radio.loadPacket(data, sizeof(data)));
+    RF_CALL_BLOCKING(radio.startTransmit());
+}
+
+#if RADIOS >= 1
+SX127x<Spi<1>, Cs<1>> radio1;
+#endif
+#if RADIOS >= 2
+SX127x<Spi<2>, Cs<2>> radio2;
+#endif
+
+}
+
+int
+main()
+{
+#if RADIOS >= 1
+    exercise(radio1);
+#endif
+#if RADIOS >= 2
+    exercise(radio2);
+#endif
+    return 0;
+}
@@ -0,0 +1,42 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+// RAM per driver object, one JSON object per line:
+//   {"bench":"ram","object":...,"bytes":...}
+
+#include <stdio.h>
+
+#include "../sx127x.hpp"
+#include "../sx127x_address_filter.hpp"
+#include "../sx127x_async.hpp"
+#include "../sx127x_energy.hpp"
+#include "../sx127x_scanner.hpp"
+#include "../sx127x_secure.hpp"
+#include "../sx127x_turnaround.hpp"
+#include "mock_radio.hpp"
+
+using namespace modm;
+using namespace sx127x_host;
+
+#define RAM(...) \
+	printf("{\"bench\":\"ram\",\"object\":\"%s\",\"bytes\":%zu}\n", #__VA_ARGS__, sizeof(__VA_ARGS__))
+
+int
+main()
+{
+	RAM(SX127xCore);
+	RAM(SX127x<MockSpiMaster, MockCs>);
+	RAM(SX127x<MockSpiMaster, MockCs, SX127xStatistics>);
+	RAM(SX127xScanner);
+	RAM(SX127xAddressFilter<2>);
+	RAM(SX127xTurnaround);
+	RAM(SX127xEnergyMeter);
+	RAM(SX127xPowerManager);
+	RAM(SX127xAsync);
+	RAM(SX127xSecureLink<SX127xAesSoftware>);
+	RAM(SX127xSecureLink<SX127xAesTable>);
+	return 0;
+}
@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef SX127X_HOST_TEST_HPP
+#define SX127X_HOST_TEST_HPP
+
+#include <stdio.h>
+
+namespace test
+{
+
+inline unsigned failures = 0;
+
+inline int
+report()
+{
+	if (failures) {
+		printf("%u check(s) failed\n", failures);
+	}
+	return failures ? 1 : 0;
+}
+
+}
+
+#define CHECK(condition) \
+	do { if (not (condition)) { \
+		printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+		test::failures++; } } while (0)
+
+#define CHECK_EQ(a, b) \
+	do { auto checkA = (a); auto checkB = (b); if (not (checkA == checkB)) { \
+		printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, \
+			   #a, #b, (long long)checkA, (long long)checkB); \
+		test::failures++; } } while (0)
+
+#endif
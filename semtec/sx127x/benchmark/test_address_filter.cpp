@@ -0,0 +1,118 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../sx127x.hpp"
+#include "../sx127x_address_filter.hpp"
+#include "mock_radio.hpp"
+#include "test.hpp"
+
+using namespace modm;
+using namespace sx127x_host;
+
+namespace
+{
+
+SX127x<MockSpiMaster, MockCs> driver;
+SX127xAddressFilter<3> filter(driver);
+
+uint8_t
+receive(std::initializer_list<uint8_t> frame)
+{
+	radio.receive(frame.begin(), uint8_t(frame.size()));
+	uint8_t buffer[16];
+	return result([&] { return filter.receive(buffer, sizeof(buffer)); });
+}
+
+void
+testValidation()
+{
+	CHECK(filter.setFilter(0, 254, 0x12, 0xff));
+	CHECK(not filter.setFilter(0, 255, 0x12, 0xff));
+	CHECK(not filter.setFilter(3, 0, 0x12, 0xff));
+	filter.clearFilter(0);
+	filter.clearFilter(3);
+}
+
+void
+testAlternatives()
+{
+	radio.reset();
+	// node address or broadcast at offset 0, network id at offset 1
+	filter.setFilter(0, 0, 0x12, 0xff);
+	filter.setFilter(1, 0, 0xff, 0xff);
+	filter.setFilter(2, 1, 0xa0, 0xf0);
+
+	CHECK_EQ(receive({0x12, 0xa5, 1, 2}), 4);
+	CHECK_EQ(receive({0xff, 0xa5, 1, 2}), 4);
+	CHECK_EQ(filter.getDrops(0) + filter.getDrops(1) + filter.getDrops(2), 0u);
+
+	// Counted once, on the first slot of the first rejecting offset
+	CHECK_EQ(receive({0x34, 0xa5, 1, 2}), 0);
+	CHECK_EQ(receive({0x12, 0xb5, 1, 2}), 0);
+	CHECK_EQ(receive({0x34, 0xb5, 1, 2}), 0);
+	CHECK_EQ(filter.getDrops(0), 2u);
+	CHECK_EQ(filter.getDrops(1), 0u);
+	CHECK_EQ(filter.getDrops(2), 1u);
+
+	// too short for the network id
+	CHECK_EQ(receive({0x12}), 0);
+	CHECK_EQ(filter.getDrops(2), 2u);
+	CHECK_EQ(filter.getDrops(3), 0u);
+
+	filter.clearFilter(2);
+	CHECK_EQ(receive({0xff}), 1);
+}
+
+void
+testSmallBuffer()
+{
+	radio.reset();
+	for (uint8_t ii = 0; ii < 3; ii++) {
+		filter.clearFilter(ii);
+	}
+	// Address behind the end of the receive buffer
+	filter.setFilter(0, 12, 0x12, 0xff);
+
+	uint8_t frame[20];
+	for (uint8_t ii = 0; ii < sizeof(frame); ii++) {
+		frame[ii] = 0x80 + ii;
+	}
+	frame[12] = 0x12;
+
+	uint8_t buffer[4];
+	radio.receive(frame, sizeof(frame));
+	CHECK_EQ(result([&] { return filter.receive(buffer, sizeof(buffer)); }), 4);
+	CHECK_EQ(buffer[0], 0x80);
+	CHECK_EQ(buffer[3], 0x83);
+	CHECK_EQ(filter.getTruncations(), 1u);
+
+	// A rejected frame is a filter drop, not a truncation
+	uint32_t drops = filter.getDrops(0);
+	frame[12] = 0x34;
+	radio.receive(frame, sizeof(frame));
+	CHECK_EQ(result([&] { return filter.receive(buffer, sizeof(buffer)); }), 0);
+	CHECK_EQ(filter.getDrops(0), drops + 1);
+	CHECK_EQ(filter.getTruncations(), 1u);
+
+	// Fitting frames are not truncated
+	frame[12] = 0x12;
+	radio.receive(frame, 13);
+	uint8_t large[16];
+	CHECK_EQ(result([&] { return filter.receive(large, sizeof(large)); }), 13);
+	CHECK_EQ(large[12], 0x12);
+	CHECK_EQ(filter.getTruncations(), 1u);
+}
+
+}
+
+int
+main()
+{
+	testValidation();
+	testAlternatives();
+	testSmallBuffer();
+	return test::report();
+}
@@ -0,0 +1,252 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../sx127x.hpp"
+#include "../sx127x_async.hpp"
+#include "mock_radio.hpp"
+#include "test.hpp"
+
+using namespace modm;
+using namespace sx127x_host;
+
+namespace
+{
+
+SX127x<MockSpiMaster, MockCs> driver;
+SX127xAsync async(driver);
+
+/// Updates a task until it finished, returns the number of updates
+template <typename T>
+uint32_t
+poll(SX127xTask<T> &task, uint32_t limit = 100000)
+{
+	uint32_t steps = 0;
+	while (steps < limit) {
+		steps++;
+		if (not task.update()) {
+			break;
+		}
+		modm_host::advance(1);
+	}
+	return steps;
+}
+
+/// Brings the radio up through the coroutine front-end only
+SX127xTask<>
+bringUp()
+{
+	co_await async.initialize();
+	co_await async.setLora();
+	co_await async.setHighFrequencyMode();
+	co_await async.setCarrierFreq(868100000);
+	co_await async.setBandwidth(sx127x::SignalBandwidth::Fr125kHz);
+	co_await async.setSpreadingFactor(sx127x::SpreadingFactor::SF9);
+	co_await async.setCodingRate(sx127x::ErrorCodingRate::Cr4_5);
+	co_await async.setExplicitHeaderMode();
+	co_await async.enablePayloadCRC();
+	co_await async.setPaBoost();
+	co_await async.setOutputPower(14);
+	co_await async.setAgcAutoOn();
+	co_await async.setDio0Mapping(1);
+	co_await async.setOperationMode(sx127x::Mode::Standby);
+}
+
+SX127xTask<bool>
+transmit(uint8_t *data, uint8_t nbBytes)
+{
+	co_await async.setPayloadLength(nbBytes);
+	co_await async.sendPacket(data, nbBytes);
+	// GCC 12 miscompiles co_await in a loop condition
+	for (;;)
+	{
+		const bool done = co_await async.getInterrupt(sx127x::RegIrqFlags::TxDone);
+		if (done) {
+			break;
+		}
+		co_await SX127xYield();
+	}
+	co_return true;
+}
+
+void
+testBringUp()
+{
+	for (uint8_t latency : {0, 3})
+	{
+		radio.reset();
+		radio.latency = latency;
+		auto task = bringUp();
+		CHECK(task.isValid());
+		// Without bus latency every operation finishes within one update
+		CHECK_EQ(poll(task) == 1, latency == 0);
+		CHECK(task.isDone());
+
+		CHECK(radio.reg[0x01] & 0x80);
+		CHECK_EQ(radio.reg[0x01] & 0x08, 0);
+		CHECK_EQ(radio.mode(), MockRadio::Standby);
+		CHECK_EQ(radio.frf(), 0xd90666u);
+		CHECK_EQ(radio.reg[0x1d] >> 4, 7);
+		CHECK_EQ(radio.reg[0x1e] >> 4, 9);
+		CHECK(radio.reg[0x1e] & 0x04);
+		CHECK(radio.reg[0x09] & 0x80);
+	}
+	CHECK_EQ(SX127xFramePool::getInUse(), 0);
+}
+
+void
+testSendReceive()
+{
+	radio.reset();
+	radio.latency = 2;
+	radio.instantTx = false;
+
+	uint8_t data[] = {1, 2, 3, 4, 5};
+	auto tx = transmit(data, sizeof(data));
+	for (uint8_t i = 0; i < 50; i++) {
+		tx.update();
+	}
+	CHECK(not tx.isDone());
+	radio.finishTransmit();
+	poll(tx);
+	CHECK(tx.getResult());
+	radio.instantTx = true;
+
+	uint8_t length;
+	const uint8_t *sent = radio.lastTx(length);
+	CHECK_EQ(length, sizeof(data));
+	CHECK(memcmp(sent, data, sizeof(data)) == 0);
+
+	uint8_t received[] = {9, 8, 7};
+	radio.receive(received, sizeof(received));
+	auto irq = async.getInterrupt(sx127x::RegIrqFlags::RxDone);
+	poll(irq);
+	CHECK(irq.getResult());
+
+	uint8_t buffer[3] = {};
+	auto payload = async.getPayload(buffer, sizeof(buffer));
+	poll(payload);
+	CHECK(memcmp(buffer, received, sizeof(buffer)) == 0);
+}
+
+void
+testFewerSteps()
+{
+	radio.reset();
+	radio.latency = 4;
+	uint8_t data[32] = {};
+
+	// Same bus transactions, but the task resumes at the pending access
+	rf::entries = 0;
+	radio.resetCounters();
+	const uint32_t resumable = run([&] { return driver.sendPacket(data, sizeof(data)); });
+	const uint32_t resumableEntries = rf::entries;
+	const uint32_t transactions = radio.counters.transactions;
+
+	rf::entries = 0;
+	radio.resetCounters();
+	auto task = async.sendPacket(data, sizeof(data));
+	CHECK_EQ(poll(task), resumable);
+	CHECK(rf::entries < resumableEntries);
+	CHECK_EQ(radio.counters.transactions, transactions);
+
+	// Both Fifo addresses are kept in the frame, read in one burst
+	radio.receive(data, sizeof(data));
+	const uint32_t steps = run([&] { return driver.getPayload(data, sizeof(data)); });
+	radio.receive(data, sizeof(data));
+	auto payload = async.getPayload(data, sizeof(data));
+	CHECK(poll(payload) < steps);
+}
+
+struct OpModeObserver : public SX127xObserver
+{
+	uint8_t count = 0;
+	sx127x::RegOpMode_t last;
+
+	void
+	onOpMode(sx127x::RegOpMode_t opMode) override
+	{
+		count++;
+		last = opMode;
+	}
+};
+
+void
+testObserver()
+{
+	radio.reset();
+	OpModeObserver observer;
+	driver.setObserver(&observer);
+	const uint8_t epoch = driver.getFifoEpoch();
+
+	// Through the sleep mode to LoRa, nested mode change to transmit
+	auto lora = async.setLora();
+	poll(lora);
+	CHECK_EQ(observer.count, 2);
+	CHECK(driver.getFifoEpoch() != epoch);
+
+	uint8_t data[] = {1, 2};
+	auto tx = async.sendPacket(data, sizeof(data));
+	poll(tx);
+	CHECK_EQ(observer.count, 3);
+	CHECK(sx127x::Mode_t::get(observer.last) == sx127x::Mode::Transmit);
+	driver.setObserver(nullptr);
+}
+
+SX127xTask<bool>
+awaitChild(SX127xTask<bool> &child)
+{
+	co_return co_await child;
+}
+
+void
+testPoolExhaustion()
+{
+	radio.reset();
+	SX127xFramePool::resetStatistics();
+	auto failed = [] {
+		// Two large frames and single block operations fill the pool
+		auto first = bringUp();
+		auto second = bringUp();
+		SX127xTask<> tasks[] = {
+			async.setLora(), async.setLora(), async.setLora(), async.setLora(),
+			async.setLora(), async.setLora(), async.setLora(), async.setLora(),
+			async.setLora(), async.setLora(), async.setLora(), async.setLora(),
+			async.setLora(), async.setLora(), async.setLora(), async.setLora()};
+		CHECK(first.isValid() and second.isValid());
+		CHECK(tasks[0].isValid());
+		CHECK_EQ(SX127xFramePool::getInUse(), SX127xFramePool::Blocks);
+		return async.getInterrupt(sx127x::RegIrqFlags::TxDone);
+	}();
+	CHECK_EQ(SX127xFramePool::getInUse(), 0);
+	CHECK_EQ(SX127xFramePool::getPeak(), SX127xFramePool::Blocks);
+	CHECK(SX127xFramePool::getFailures() > 0);
+	CHECK(SX127xFramePool::getLargestFrame() > SX127xFramePool::BlockSize);
+
+	CHECK(not failed.isValid());
+	CHECK(failed.isDone());
+	CHECK(not failed.update());
+	CHECK(not failed.getResult());
+
+	// Awaiting an invalid task finishes right away without a result
+	auto parent = awaitChild(failed);
+	CHECK(parent.isValid());
+	CHECK_EQ(poll(parent), 1u);
+	CHECK(not parent.getResult());
+}
+
+}
+
+int
+main()
+{
+	testBringUp();
+	testSendReceive();
+	testFewerSteps();
+	testObserver();
+	testPoolExhaustion();
+	CHECK_EQ(SX127xFramePool::getInUse(), 0);
+	return test::report();
+}
@@ -0,0 +1,74 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../sx127x.hpp"
+#include "mock_radio.hpp"
+#include "test.hpp"
+
+using namespace modm;
+using namespace sx127x_host;
+
+namespace
+{
+
+SX127x<MockSpiMaster, MockCs> driver;
+
+void
+testConfiguration()
+{
+	radio.reset();
+	radio.latency = 3;
+	run([] { return driver.initialize(); });
+	run([] { return driver.setLora(); });
+	CHECK(radio.reg[0x01] & 0x80);
+
+	run([] { return driver.setCarrierFreq(868100000); });
+	CHECK_EQ(radio.frf(), 0xd90666u);
+
+	run([] { return driver.setSpreadingFactor(sx127x::SpreadingFactor::SF9); });
+	CHECK_EQ(radio.reg[0x1e] >> 4, 9);
+	run([] { return driver.setBandwidth(sx127x::SignalBandwidth::Fr250kHz); });
+	CHECK_EQ(radio.reg[0x1d] >> 4, 8);
+}
+
+void
+testSendPacket()
+{
+	radio.reset();
+	uint8_t data[] = {1, 2, 3, 4, 5};
+	run([] { return driver.setPayloadLength(5); });
+	run([&] { return driver.sendPacket(data, sizeof(data)); });
+
+	uint8_t length;
+	const uint8_t *sent = radio.lastTx(length);
+	CHECK_EQ(length, sizeof(data));
+	CHECK(memcmp(sent, data, sizeof(data)) == 0);
+	CHECK(result([] { return driver.getInterrupt(sx127x::RegIrqFlags::TxDone); }));
+}
+
+void
+testGetPayload()
+{
+	radio.reset();
+	uint8_t data[] = {9, 8, 7};
+	radio.receive(data, sizeof(data));
+	CHECK(result([] { return driver.getInterrupt(sx127x::RegIrqFlags::RxDone); }));
+
+	uint8_t buffer[3] = {};
+	run([&] { return driver.getPayload(buffer, sizeof(buffer)); });
+	CHECK(memcmp(buffer, data, sizeof(data)) == 0);
+}
+
+}
+
+int
+main()
+{
+	testConfiguration();
+	testSendPacket();
+	testGetPayload();
+	return test::report();
+}
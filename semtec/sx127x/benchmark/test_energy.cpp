@@ -0,0 +1,164 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../sx127x.hpp"
+#include "../sx127x_energy.hpp"
+#include "mock_radio.hpp"
+#include "test.hpp"
+
+using namespace modm;
+using namespace sx127x_host;
+using State = SX127xEnergyMeter::State;
+
+namespace
+{
+
+constexpr SX127xEnergyMeter::CurrentTable table = {
+	1, 1600, 5000, 11500, 11000,
+	{20000, 20000, 20000, 20000, 20000, 20000, 20000, 20000,
+	 20000, 20000, 20000, 20000, 20000, 20000, 20000, 29000},
+	{87000, 87000, 87000, 87000, 87000, 87000, 87000, 87000,
+	 87000, 87000, 87000, 87000, 87000, 87000, 87000, 120000}
+};
+
+SX127x<MockSpiMaster, MockCs> driver;
+SX127xEnergyMeter meter(table);
+SX127xPowerManager power(driver, meter, std::chrono::milliseconds(10));
+
+void
+setUp()
+{
+	radio.reset();
+	driver.setObserver(&meter);
+	run([] { return driver.setLora(); });
+	run([] { return driver.setOperationMode(sx127x::Mode::Standby); });
+	meter.reset();
+}
+
+void
+testSameModeWrites()
+{
+	setUp();
+	const auto last = meter.getLastTransition();
+	modm_host::advance(1000);
+
+	run([] { return driver.setLowFrequencyMode(); });
+	run([] { return driver.setHighFrequencyMode(); });
+	CHECK_EQ(meter.getTransitions(), 0u);
+	CHECK(meter.getLastTransition() == last);
+	CHECK(not (meter.getOpMode() & sx127x::RegOpMode::LowFrequencyModeOn));
+}
+
+void
+testAutomaticStandby()
+{
+	setUp();
+	radio.instantTx = false;
+	uint8_t data[8] = {};
+	run([] { return driver.setPayloadLength(8); });
+	run([&] { return driver.sendPacket(data, sizeof(data)); });
+	CHECK(meter.getState() == State::Tx);
+
+	modm_host::advance(5000);
+	radio.finishTransmit();
+	CHECK(result([] { return driver.getInterrupt(sx127x::RegIrqFlags::TxDone); }));
+	CHECK(meter.getState() == State::Standby);
+
+	// No further transmit current after TxDone
+	modm_host::advance(5000);
+	meter.update();
+	const uint64_t tx = meter.getTime(State::Tx);
+	CHECK(tx >= 5000 and tx < 5200);
+
+	// Single receive returns to standby on timeout
+	run([] { return driver.setOperationMode(sx127x::Mode::RecvSingle); });
+	CHECK(meter.getState() == State::Rx);
+	radio.receiveTimeout();
+	result([] { return driver.getInterrupt(sx127x::RegIrqFlags::RxTimeout); });
+	CHECK(meter.getState() == State::Standby);
+
+	// Continuous receive does not
+	run([] { return driver.setOperationMode(sx127x::Mode::RecvCont); });
+	uint8_t frame[] = {1};
+	radio.receive(frame, 1);
+	result([] { return driver.getInterrupt(sx127x::RegIrqFlags::RxDone); });
+	CHECK(meter.getState() == State::Rx);
+}
+
+void
+testPowerManager()
+{
+	setUp();
+	radio.instantTx = true;
+	uint8_t data[4] = {};
+	run([&] { return driver.sendPacket(data, sizeof(data)); });
+	result([] { return driver.getInterrupt(sx127x::RegIrqFlags::TxDone); });
+
+	run([] { return power.update(); });
+	CHECK(not power.isSleeping());
+
+	modm_host::advance(10000);
+	radio.resetCounters();
+	run([] { return power.update(); });
+	CHECK(power.isSleeping());
+	CHECK_EQ(radio.mode(), 0x00);
+	CHECK_EQ(radio.counters.transactions, 1u);
+
+	// A mode change while sleeping is followed, resume must not undo it
+	run([] { return driver.setLowFrequencyMode(); });
+	run([] { return power.resume(); });
+	CHECK_EQ(radio.mode(), MockRadio::Standby);
+	CHECK(radio.reg[0x01] & 0x08);
+	CHECK(radio.reg[0x01] & 0x80);
+}
+
+void
+testClockWraparound()
+{
+	setUp();
+	// PreciseClock wraps 1 ms into a transmission
+	modm_host::microseconds = (modm_host::microseconds | 0xffffffffull) - 1000;
+	meter.reset();
+	radio.instantTx = false;
+	uint8_t data[8] = {};
+	run([&] { return driver.sendPacket(data, sizeof(data)); });
+	modm_host::advance(5000);
+	meter.update();
+	CHECK(meter.getTime(State::Tx) >= 5000 and meter.getTime(State::Tx) < 5200);
+	radio.finishTransmit();
+	result([] { return driver.getInterrupt(sx127x::RegIrqFlags::TxDone); });
+	radio.instantTx = true;
+}
+
+void
+testLongSleep()
+{
+	setUp();
+	run([] { return driver.setOperationMode(sx127x::Mode::Sleep); });
+	meter.reset();
+
+	// Three hours asleep, longer than the PreciseClock range, with the
+	// power manager woken up every half hour
+	for (uint8_t i = 0; i < 6; i++) {
+		modm_host::advance(1800000000ull);
+		run([] { return power.update(); });
+	}
+	CHECK_EQ(meter.getTime(State::Sleep), 10800000000ull);
+	CHECK_EQ(meter.getCharge(), 10800u);
+}
+
+}
+
+int
+main()
+{
+	testSameModeWrites();
+	testAutomaticStandby();
+	testPowerManager();
+	testClockWraparound();
+	testLongSleep();
+	return test::report();
+}
@@ -0,0 +1,138 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../sx127x_fec.hpp"
+#include "test.hpp"
+
+using namespace modm;
+using Fec = SX127xFec<8, 4, 32>;
+
+namespace
+{
+
+uint32_t seed = 1;
+
+uint32_t
+random()
+{
+	seed = seed * 1103515245u + 12345u;
+	return seed >> 16;
+}
+
+void
+testField()
+{
+	for (unsigned a = 1; a < 256; a++) {
+		CHECK_EQ(SX127xFecCodec::multiply(uint8_t(a), SX127xFecCodec::inverse(uint8_t(a))), 1);
+	}
+	CHECK_EQ(SX127xFecCodec::multiply(0x53, 0xca), 0x8f);
+
+	// Word-at-a-time multiplyAdd against the scalar multiplication
+	uint8_t src[37], dst[37], expected[37];
+	for (uint8_t i = 0; i < sizeof(src); i++) {
+		src[i] = uint8_t(random());
+		dst[i] = expected[i] = uint8_t(random());
+		expected[i] ^= SX127xFecCodec::multiply(0x1d, src[i]);
+	}
+	SX127xFecCodec::multiplyAdd(dst, src, 0x1d, sizeof(src));
+	CHECK(memcmp(dst, expected, sizeof(dst)) == 0);
+}
+
+void
+testRandomErasures()
+{
+	Fec tx, rx;
+	uint8_t original[Fec::MessageSize];
+	uint8_t frame[Fec::FrameSize];
+
+	for (uint16_t trial = 0; trial < 200; trial++)
+	{
+		for (uint8_t &b : original) {
+			b = uint8_t(random());
+		}
+		memcpy(tx.getMessage(), original, sizeof(original));
+		tx.encode(uint8_t(trial));
+
+		// Random order, up to M frames lost
+		uint8_t order[Fec::Fragments];
+		for (uint8_t i = 0; i < Fec::Fragments; i++) {
+			order[i] = i;
+		}
+		for (uint8_t i = Fec::Fragments - 1; i > 0; i--) {
+			uint8_t j = random() % (i + 1);
+			uint8_t t = order[i]; order[i] = order[j]; order[j] = t;
+		}
+		const uint8_t lost = random() % (4 + 1);
+
+		uint8_t completions = 0;
+		for (uint8_t i = lost; i < Fec::Fragments; i++) {
+			CHECK_EQ(tx.getFrame(order[i], frame), Fec::FrameSize);
+			completions += rx.putFrame(frame, Fec::FrameSize);
+		}
+		CHECK_EQ(completions, 1);
+		CHECK(rx.isComplete());
+		CHECK(memcmp(rx.getMessage(), original, sizeof(original)) == 0);
+	}
+}
+
+void
+testStaleMessage()
+{
+	Fec tx, rx;
+	uint8_t frame[Fec::FrameSize];
+	memset(tx.getMessage(), 0xab, Fec::MessageSize);
+	tx.encode(7);
+
+	for (uint8_t i = 0; i < 8; i++) {
+		tx.getFrame(i, frame);
+		CHECK_EQ(rx.putFrame(frame, Fec::FrameSize), i == 7);
+	}
+	// A repetition of the decoded message is not reported again
+	for (uint8_t i = 0; i < Fec::Fragments; i++) {
+		tx.getFrame(i, frame);
+		CHECK(not rx.putFrame(frame, Fec::FrameSize));
+	}
+
+	// Another id in between starts a new message, even one reusing id 7
+	tx.encode(8);
+	tx.getFrame(0, frame);
+	CHECK(not rx.putFrame(frame, Fec::FrameSize));
+	CHECK(not rx.isComplete());
+	tx.encode(7);
+	for (uint8_t i = 4; i < Fec::Fragments; i++) {
+		tx.getFrame(i, frame);
+		CHECK_EQ(rx.putFrame(frame, Fec::FrameSize), i == 11);
+	}
+}
+
+void
+testBounds()
+{
+	Fec fec;
+	uint8_t frame[Fec::FrameSize];
+	CHECK_EQ(fec.getFrame(Fec::Fragments, frame), 0);
+	CHECK_EQ(fec.getFrame(0xff, frame), 0);
+
+	frame[0] = 0;
+	frame[1] = Fec::Fragments;
+	CHECK(not fec.putFrame(frame, Fec::FrameSize));
+	CHECK(not fec.putFrame(frame, Fec::FrameSize - 1));
+}
+
+}
+
+int
+main()
+{
+	testField();
+	testRandomErasures();
+	testStaleMessage();
+	testBounds();
+	return test::report();
+}
@@ -0,0 +1,61 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../sx127x.hpp"
+#include "../sx127x_scanner.hpp"
+#include "mock_radio.hpp"
+#include "test.hpp"
+
+using namespace modm;
+using namespace sx127x_host;
+
+namespace
+{
+
+SX127x<MockSpiMaster, MockCs> driver;
+SX127xScanner scanner(driver);
+
+constexpr sx127x::Frf channels[] = {
+	sx127x::toFrf(868100000), sx127x::toFrf(868300000), sx127x::toFrf(868500000)
+};
+
+uint8_t
+channelRssi(uint32_t frf)
+{
+	// Only the second channel is occupied
+	const auto busy = channels[1].value;
+	return frf == ((uint32_t(busy[0]) << 16) | (busy[1] << 8) | busy[2]) ? 90 : 20;
+}
+
+void
+testScan()
+{
+	radio.reset();
+	radio.latency = 2;
+	radio.rssi = channelRssi;
+	run([] { return driver.setLora(); });
+	run([] { return driver.setCarrierFreq(869525000); });
+	const uint32_t tuned = radio.frf();
+
+	uint8_t histogram[3];
+	run([&] { return scanner.scan(channels, 3, 4, histogram); });
+
+	CHECK_EQ(histogram[0], 20);
+	CHECK_EQ(histogram[1], 90);
+	CHECK_EQ(histogram[2], 20);
+	CHECK_EQ(radio.frf(), tuned);
+	CHECK_EQ(radio.mode(), MockRadio::Standby);
+	CHECK(radio.reg[0x01] & 0x80);
+}
+
+}
+
+int
+main()
+{
+	testScan();
+	return test::report();
+}
@@ -0,0 +1,216 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../sx127x.hpp"
+#include "../sx127x_secure.hpp"
+#include "mock_radio.hpp"
+#include "test.hpp"
+
+using namespace modm;
+using namespace sx127x_host;
+
+namespace
+{
+
+SX127x<MockSpiMaster, MockCs> driver;
+
+const uint8_t linkKey[16] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+	0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+/// FIPS-197 appendix C.1
+template <typename Aes>
+void
+testAes()
+{
+	const uint8_t key[16] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+		0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+	const uint8_t expected[16] = {
+		0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+		0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a};
+	uint8_t block[16] = {
+		0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+		0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+
+	Aes aes;
+	aes.setKey(key);
+	aes.encrypt(block);
+	CHECK(memcmp(block, expected, sizeof(block)) == 0);
+}
+
+/// RFC 3610 packet vector #1
+template <typename Aes>
+void
+testCcm()
+{
+	const uint8_t key[16] = {
+		0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+		0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf};
+	const uint8_t nonce[13] = {
+		0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5};
+	const uint8_t aad[8] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+	const uint8_t ciphertext[23] = {
+		0x58, 0x8c, 0x97, 0x9a, 0x61, 0xc6, 0x63, 0xd2, 0xf0, 0x66, 0xd0, 0xc2,
+		0xc0, 0xf9, 0x89, 0x80, 0x6d, 0x5f, 0x6b, 0x61, 0xda, 0xc3, 0x84};
+	const uint8_t expectedMic[8] = {0x17, 0xe8, 0xd1, 0x2c, 0xfd, 0xf9, 0x26, 0xe0};
+
+	uint8_t plaintext[23], data[23], mic[8];
+	for (uint8_t i = 0; i < sizeof(plaintext); i++) {
+		plaintext[i] = data[i] = 0x08 + i;
+	}
+
+	SX127xCcm<Aes, 8> ccm;
+	ccm.setKey(key);
+	ccm.begin(nonce, aad, sizeof(aad), sizeof(data));
+	// All chunks but the last are multiples of 16 bytes
+	ccm.encrypt(data, 16);
+	ccm.encrypt(data + 16, 7);
+	ccm.finish(mic);
+	CHECK(memcmp(data, ciphertext, sizeof(data)) == 0);
+	CHECK(memcmp(mic, expectedMic, sizeof(mic)) == 0);
+
+	ccm.begin(nonce, aad, sizeof(aad), sizeof(data));
+	ccm.decrypt(data, sizeof(data));
+	CHECK(ccm.verify(mic));
+	CHECK(memcmp(data, plaintext, sizeof(data)) == 0);
+
+	// One call for a payload beyond 239 bytes
+	uint8_t large[250] = {};
+	ccm.begin(nonce, aad, sizeof(aad), sizeof(large));
+	ccm.encrypt(large, sizeof(large));
+	ccm.finish(mic);
+	ccm.begin(nonce, aad, sizeof(aad), sizeof(large));
+	ccm.decrypt(large, sizeof(large));
+	CHECK(ccm.verify(mic));
+
+	mic[7] ^= 0x01;
+	ccm.begin(nonce, aad, sizeof(aad), sizeof(data));
+	ccm.decrypt(data, sizeof(data));
+	CHECK(not ccm.verify(mic));
+}
+
+/// Puts the last transmitted frame into the receive Fifo
+void
+loopBack()
+{
+	uint8_t length;
+	const uint8_t *frame = radio.lastTx(length);
+	uint8_t copy[255];
+	memcpy(copy, frame, length);
+	radio.receive(copy, length);
+}
+
+void
+testLink()
+{
+	radio.reset();
+	radio.latency = 2;
+	SX127xSecureLink<> alice(driver, 1, 2);
+	SX127xSecureLink<SX127xAesTable> bob(driver, 2, 1);
+	SX127xSecureLink<> mallory(driver, 3, 2);
+	alice.setKey(linkKey);
+	bob.setKey(linkKey);
+	mallory.setKey(linkKey);
+
+	const uint8_t message[40] = "A secret message across several blocks";
+	uint8_t data[64], buffer[64];
+
+	// Roundtrip between both backends
+	memcpy(data, message, sizeof(message));
+	CHECK(result([&] { return alice.send(data, sizeof(message)); }));
+	CHECK(memcmp(data, message, sizeof(message)) != 0);
+	uint8_t length;
+	radio.lastTx(length);
+	CHECK_EQ(length, sizeof(message) + SX127xSecureLink<>::Overhead);
+
+	loopBack();
+	CHECK_EQ(result([&] { return bob.receive(buffer, sizeof(buffer)); }), sizeof(message));
+	CHECK(memcmp(buffer, message, sizeof(message)) == 0);
+
+	// The same frame again is a replay
+	loopBack();
+	CHECK_EQ(result([&] { return bob.receive(buffer, sizeof(buffer)); }), 0);
+	CHECK_EQ(bob.getReplayDrops(), 1u);
+
+	// Alice does not accept her own frame
+	loopBack();
+	CHECK_EQ(result([&] { return alice.receive(buffer, sizeof(buffer)); }), 0);
+	CHECK_EQ(alice.getForeignDrops(), 1u);
+
+	// A third node with the key has its own counters, but is not the peer
+	memcpy(data, message, sizeof(message));
+	CHECK(result([&] { return mallory.send(data, sizeof(message)); }));
+	loopBack();
+	CHECK_EQ(result([&] { return bob.receive(buffer, sizeof(buffer)); }), 0);
+	CHECK_EQ(bob.getForeignDrops(), 1u);
+	CHECK_EQ(bob.getReplayDrops(), 1u);
+
+	// Tampered ciphertext
+	memcpy(data, message, sizeof(message));
+	CHECK(result([&] { return alice.send(data, sizeof(message)); }));
+	{
+		uint8_t copy[255];
+		const uint8_t *frame = radio.lastTx(length);
+		memcpy(copy, frame, length);
+		copy[SX127xSecureLink<>::HeaderSize] ^= 0x80;
+		radio.receive(copy, length);
+	}
+	CHECK_EQ(result([&] { return bob.receive(buffer, sizeof(buffer)); }), 0);
+	CHECK_EQ(bob.getAuthFailures(), 1u);
+	for (uint8_t i = 0; i < sizeof(message); i++) {
+		CHECK_EQ(buffer[i], 0);
+	}
+
+	// Frames shorter than the overhead or longer than the buffer
+	radio.receive(data, SX127xSecureLink<>::Overhead - 1);
+	CHECK_EQ(result([&] { return bob.receive(buffer, sizeof(buffer)); }), 0);
+	memcpy(data, message, sizeof(message));
+	CHECK(result([&] { return alice.send(data, sizeof(message)); }));
+	loopBack();
+	CHECK_EQ(result([&] { return bob.receive(buffer, sizeof(message) - 1); }), 0);
+	CHECK_EQ(bob.getLengthErrors(), 2u);
+
+	// Counters keep going after rejected frames
+	memcpy(data, message, sizeof(message));
+	CHECK(result([&] { return alice.send(data, sizeof(message)); }));
+	loopBack();
+	CHECK_EQ(result([&] { return bob.receive(buffer, sizeof(buffer)); }), sizeof(message));
+	CHECK_EQ(alice.getTxCounter(), 4u);
+}
+
+void
+testOversize()
+{
+	radio.reset();
+	SX127xSecureLink<> link(driver, 1, 2);
+	link.setKey(linkKey);
+	uint8_t data[255] = {};
+
+	radio.resetCounters();
+	CHECK(not result([&] { return link.send(data, 255 - SX127xSecureLink<>::Overhead + 1); }));
+	CHECK_EQ(radio.counters.transactions, 0u);
+	CHECK_EQ(link.getTxCounter(), 0u);
+
+	CHECK(result([&] { return link.send(data, 255 - SX127xSecureLink<>::Overhead); }));
+	uint8_t length;
+	radio.lastTx(length);
+	CHECK_EQ(length, 255);
+}
+
+}
+
+int
+main()
+{
+	testAes<SX127xAesSoftware>();
+	testAes<SX127xAesTable>();
+	testCcm<SX127xAesSoftware>();
+	testCcm<SX127xAesTable>();
+	testLink();
+	testOversize();
+	return test::report();
+}
@@ -0,0 +1,128 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../sx127x.hpp"
+#include "../sx127x_sniffer.hpp"
+#include "mock_radio.hpp"
+#include "test.hpp"
+
+using namespace modm;
+using namespace sx127x_host;
+
+namespace
+{
+
+SX127x<MockSpiMaster, MockCs> driver;
+
+void
+testStart()
+{
+	radio.reset();
+	SX127xSniffer<4> sniffer(driver, 0x34);
+	run([&] { return sniffer.start(868100000, sx127x::SignalBandwidth::Fr250kHz,
+								   sx127x::SpreadingFactor::SF9); });
+
+	CHECK_EQ(radio.reg[uint8_t(Address::SyncWord)], 0x34);
+	CHECK_EQ(radio.frf(), 0xd90666u);
+	CHECK_EQ(radio.reg[0x1d] >> 4, 8);
+	CHECK_EQ(radio.reg[0x1e] >> 4, 9);
+	CHECK_EQ(radio.mode(), 0x05);
+}
+
+void
+testCaptureSettings()
+{
+	radio.reset();
+	SX127xSniffer<4> sniffer(driver, 0x34);
+	const uint8_t frame[] = {0xde, 0xad, 0xbe, 0xef};
+
+	run([&] { return sniffer.start(868100000, sx127x::SignalBandwidth::Fr125kHz,
+								   sx127x::SpreadingFactor::SF7); });
+	radio.receive(frame, sizeof(frame), -8, 70);
+	run([&] { return sniffer.update(); });
+
+	// Frames already in the ring keep the settings they were received with
+	run([&] { return sniffer.start(869525000, sx127x::SignalBandwidth::Fr500kHz,
+								   sx127x::SpreadingFactor::SF12); });
+	radio.receive(frame, 2);
+	radio.reg[uint8_t(Address::IrqFlags)] |= uint8_t(sx127x::RegIrqFlags::PayloadCrcError);
+	run([&] { return sniffer.update(); });
+
+	const auto *capture = sniffer.front();
+	CHECK(capture != nullptr);
+	CHECK_EQ(capture->frequency, 868100000u);
+	CHECK_EQ(capture->bandwidth, 1);
+	CHECK_EQ(capture->spreadingFactor, 7);
+	CHECK_EQ(capture->syncWord, 0x34);
+	CHECK_EQ(capture->snr, -8);
+	CHECK_EQ(capture->rssi, 70);
+	CHECK(not capture->crcError);
+	CHECK_EQ(capture->length, sizeof(frame));
+	CHECK(memcmp(capture->data, frame, sizeof(frame)) == 0);
+
+	uint8_t pcap[64];
+	const size_t size = sniffer.exportPcap(pcap, sizeof(pcap));
+	CHECK_EQ(size, SX127xSniffer<4>::PcapRecordHeaderSize +
+				   SX127xSniffer<4>::LoraTapHeaderSize + sizeof(frame));
+	const uint8_t *loraTap = pcap + SX127xSniffer<4>::PcapRecordHeaderSize;
+	CHECK_EQ(loraTap[8], 1);
+	CHECK_EQ(loraTap[9], 7);
+	CHECK_EQ(loraTap[14], 0x34);
+
+	capture = sniffer.front();
+	CHECK(capture != nullptr);
+	CHECK_EQ(capture->frequency, 869525000u);
+	CHECK_EQ(capture->bandwidth, 4);
+	CHECK_EQ(capture->spreadingFactor, 12);
+	CHECK(capture->crcError);
+	CHECK_EQ(sniffer.exportPcap(pcap, sizeof(pcap)), size - 2);
+	CHECK_EQ(loraTap[8], 4);
+	CHECK_EQ(loraTap[9], 12);
+	CHECK(sniffer.front() == nullptr);
+}
+
+void
+testDropped()
+{
+	radio.reset();
+	SX127xSniffer<2, 8> sniffer(driver);
+	uint8_t frame[16] = {1, 2, 3};
+
+	for (uint8_t i = 0; i < 5; i++)
+	{
+		frame[0] = i;
+		radio.receive(frame, sizeof(frame));
+		run([&] { return sniffer.update(); });
+		CHECK_EQ(radio.reg[uint8_t(Address::IrqFlags)] & MockRadio::RxDone, 0);
+	}
+	CHECK_EQ(sniffer.getDropped(), 3u);
+
+	// Truncated to the Mtu, the length on air is kept
+	const auto *capture = sniffer.front();
+	CHECK_EQ(capture->data[0], 0);
+	CHECK_EQ(capture->length, sizeof(frame));
+	sniffer.pop();
+	CHECK_EQ(sniffer.front()->data[0], 1);
+	sniffer.pop();
+	CHECK(sniffer.front() == nullptr);
+
+	// Space again after the consumer caught up
+	radio.receive(frame, sizeof(frame));
+	run([&] { return sniffer.update(); });
+	CHECK(sniffer.front() != nullptr);
+	CHECK_EQ(sniffer.getDropped(), 3u);
+}
+
+}
+
+int
+main()
+{
+	testStart();
+	testCaptureSettings();
+	testDropped();
+	return test::report();
+}
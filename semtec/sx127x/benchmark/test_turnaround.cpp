@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../sx127x.hpp"
+#include "../sx127x_turnaround.hpp"
+#include "mock_radio.hpp"
+#include "test.hpp"
+
+using namespace modm;
+using namespace sx127x_host;
+
+namespace
+{
+
+SX127x<MockSpiMaster, MockCs> driver;
+SX127xTurnaround turnaround(driver);
+uint8_t reply[] = {0xaa, 0x55, 0x01};
+
+void
+testUnprepared()
+{
+	radio.reset();
+	run([] { return driver.setLora(); });
+	run([] { return driver.setOperationMode(sx127x::Mode::Standby); });
+	run([] { return driver.loadPacket(reply, sizeof(reply)); });
+	run([] { return turnaround.transmit(); });
+
+	uint8_t length;
+	const uint8_t *data = radio.lastTx(length);
+	CHECK_EQ(length, sizeof(reply));
+	CHECK(memcmp(data, reply, sizeof(reply)) == 0);
+	CHECK_EQ(radio.fifoWriteErrors, 0u);
+	CHECK_EQ(turnaround.getStatistics().count, 0u);
+}
+
+void
+testPrepared()
+{
+	radio.reset();
+	radio.instantTx = false;
+	run([] { return driver.setLora(); });
+	run([] { return driver.setOperationMode(sx127x::Mode::Standby); });
+
+	// The Fifo is filled in standby, before the synthesizer is parked
+	run([] { return driver.loadPacket(reply, sizeof(reply)); });
+	run([] { return turnaround.prepare(); });
+	CHECK_EQ(radio.mode(), 0x02);
+	radio.resetCounters();
+	run([] { return turnaround.transmit(); });
+	CHECK_EQ(radio.counters.transactions, 1u);
+	CHECK_EQ(radio.mode(), MockRadio::Transmit);
+	CHECK(radio.reg[0x01] & 0x80);
+	CHECK_EQ(turnaround.getStatistics().count, 1u);
+	radio.finishTransmit();
+	uint8_t length;
+	const uint8_t *data = radio.lastTx(length);
+	CHECK_EQ(length, sizeof(reply));
+	CHECK(memcmp(data, reply, sizeof(reply)) == 0);
+	CHECK_EQ(radio.fifoWriteErrors, 0u);
+
+	// A second transmit without prepare() reads OpMode again
+	radio.resetCounters();
+	run([] { return turnaround.transmit(); });
+	CHECK_EQ(radio.counters.transactions, 2u);
+	CHECK_EQ(turnaround.getStatistics().count, 1u);
+}
+
+}
+
+int
+main()
+{
+	testUnprepared();
+	testPrepared();
+	return test::report();
+}
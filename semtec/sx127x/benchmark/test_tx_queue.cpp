@@ -0,0 +1,182 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../sx127x.hpp"
+#include "../sx127x_tx_queue.hpp"
+#include "mock_radio.hpp"
+#include "test.hpp"
+
+using namespace modm;
+using namespace sx127x_host;
+using Queue = SX127xTxQueue<4, 16>;
+
+namespace
+{
+
+SX127x<MockSpiMaster, MockCs> driver;
+
+uint8_t
+sent()
+{
+	uint8_t length;
+	const uint8_t *data = radio.lastTx(length);
+	return length ? data[0] : 0;
+}
+
+void
+setUp()
+{
+	radio.reset();
+	radio.instantTx = false;
+	run([] { return driver.setLora(); });
+	run([] { return driver.setOperationMode(sx127x::Mode::Standby); });
+}
+
+void
+testImmediateStart()
+{
+	setUp();
+	Queue queue(driver);
+	const uint8_t low[] = {0x30};
+	queue.push(Queue::Priority::Low, low, 1);
+
+	// Channel free: loaded and started in the same pass
+	run([&] { return queue.update(); });
+	CHECK_EQ(radio.mode(), MockRadio::Transmit);
+	CHECK(queue.isEmpty());
+	CHECK_EQ(queue.getPreemptions(), 0u);
+}
+
+void
+testDutyCyclePreemption()
+{
+	setUp();
+	Queue queue(driver);
+	queue.setDutyCycle(10);
+
+	const uint8_t normal[] = {0x20};
+	const uint8_t low[] = {0x30};
+	const uint8_t urgent[] = {0x10};
+	queue.push(Queue::Priority::Normal, normal, 1);
+	run([&] { return queue.update(); });
+
+	// 100 ms airtime at 1% holds the channel back for 9.9 s
+	modm_host::advance(100000);
+	radio.finishTransmit();
+	CHECK_EQ(sent(), 0x20);
+	run([&] { return queue.update(); });
+
+	queue.push(Queue::Priority::Low, low, 1);
+	run([&] { return queue.update(); });
+	CHECK_EQ(radio.mode(), MockRadio::Standby);
+
+	queue.push(Queue::Priority::Urgent, urgent, 1);
+	run([&] { return queue.update(); });
+	CHECK_EQ(queue.getPreemptions(), 1u);
+	CHECK_EQ(radio.mode(), MockRadio::Standby);
+
+	modm_host::advance(9900000);
+	run([&] { return queue.update(); });
+	CHECK_EQ(radio.mode(), MockRadio::Transmit);
+	radio.finishTransmit();
+	CHECK_EQ(sent(), 0x10);
+	CHECK_EQ(queue.getLatency(Queue::Priority::Urgent).count, 1u);
+	CHECK(not queue.isEmpty());
+}
+
+void
+testFifoLostInSleep()
+{
+	setUp();
+	Queue queue(driver);
+	queue.setTxEnabled(false);
+
+	const uint8_t frame[] = {0x42, 0x43};
+	queue.push(Queue::Priority::Normal, frame, 2);
+	run([&] { return queue.update(); });
+
+	// e.g. SX127xPowerManager puts the idle radio to sleep
+	run([] { return driver.setOperationMode(sx127x::Mode::Sleep); });
+
+	queue.setTxEnabled(true);
+	run([&] { return queue.update(); });
+	CHECK_EQ(radio.mode(), MockRadio::Transmit);
+	radio.finishTransmit();
+
+	uint8_t length;
+	const uint8_t *data = radio.lastTx(length);
+	CHECK_EQ(length, 2);
+	CHECK_EQ(data[0], 0x42);
+	CHECK_EQ(data[1], 0x43);
+}
+
+void
+testLeavesReceiveMode()
+{
+	setUp();
+	Queue queue(driver);
+	queue.setTxEnabled(false);
+	run([] { return driver.setOperationMode(sx127x::Mode::RecvCont); });
+
+	// A held back frame does not cut off the reception
+	const uint8_t frame[] = {0x51, 0x52};
+	queue.push(Queue::Priority::Normal, frame, 2);
+	run([&] { return queue.update(); });
+	CHECK_EQ(radio.mode(), 0x05);
+
+	// Standby before the Fifo is loaded, no jump from RX to TX
+	queue.setTxEnabled(true);
+	run([&] { return queue.update(); });
+	CHECK_EQ(radio.mode(), MockRadio::Transmit);
+	radio.finishTransmit();
+	CHECK_EQ(sent(), 0x51);
+	CHECK_EQ(radio.fifoWriteErrors, 0u);
+}
+
+void
+testHoldOffAcrossWraparound()
+{
+	setUp();
+	// The millisecond clock wraps 4.9 s after the first transmission
+	modm_host::microseconds = (0x100000000ull - 5000) * 1000;
+	Queue queue(driver);
+	queue.setDutyCycle(10);
+
+	const uint8_t first[] = {0x61};
+	const uint8_t second[] = {0x62};
+	queue.push(Queue::Priority::Normal, first, 1);
+	run([&] { return queue.update(); });
+	modm_host::advance(100000);
+	radio.finishTransmit();
+	run([&] { return queue.update(); });
+
+	// The end of the hold-off lies behind the wraparound
+	queue.push(Queue::Priority::Normal, second, 1);
+	run([&] { return queue.update(); });
+	CHECK_EQ(radio.mode(), MockRadio::Standby);
+	modm_host::advance(9700000);
+	run([&] { return queue.update(); });
+	CHECK_EQ(radio.mode(), MockRadio::Standby);
+
+	modm_host::advance(200000);
+	run([&] { return queue.update(); });
+	CHECK_EQ(radio.mode(), MockRadio::Transmit);
+	radio.finishTransmit();
+	CHECK_EQ(sent(), 0x62);
+}
+
+}
+
+int
+main()
+{
+	testImmediateStart();
+	testDutyCyclePreemption();
+	testFifoLostInSleep();
+	testLeavesReceiveMode();
+	testHoldOffAcrossWraparound();
+	return test::report();
+}
@@ -3,136 +3,93 @@
 
 #include <modm/architecture/interface/spi_device.hpp>
 
-#include "sx127x_definitions.hpp"
+#include "sx127x_core.hpp"
 
 namespace modm
 {
 
-template <typename SpiMaster, typename Cs>
-class SX127x : public sx127x, public SpiDevice<SpiMaster>, protected NestedResumable<2>
+/// Statistics policy of SX127x that counts nothing and takes no space
+class SX127xNoStatistics
 {
-public:
-	SX127x();
-
-    ///
-	ResumableResult<void>
-	initialize();
-
-    // -- Basic I/O ------------------------------------------------------------
-
-    /**
-     *  Write access to specified SX127x register.
-     *
-     *  Writes exactly one byte of data to the register specified by it's
-     *  address.
-     *
-     *  @param addr Address of the register to write to.
-     *  @param data Databyte to write to the specified address.
-     */
-    ResumableResult<void>
-    write(Address addr, uint8_t data);
-
-    ResumableResult<void>
-    write(Address addr, uint8_t *data, uint8_t nbBytes);
-
-    ResumableResult<void>
-    read(Address addr, uint8_t *data, uint8_t nbBytes);
-
-    // -- Advanced I/O ---------------------------------------------------------
-    ResumableResult<void>
-    setLora();
-
-    //xpcc::ResumableResult<void>
-    //setFSK();
-
-    ResumableResult<void>
-    setLowFrequencyMode();
-
-    ResumableResult<void>
-    setHighFrequencyMode();
-
-    ResumableResult<void>
-    setLnaGain(uint8_t gain);
-
-    ResumableResult<void>
-    setLnaBoostHf();
-
-    //xpcc::ResumableResult<void>
-    //setHighFrequencyMode();
-    ResumableResult<void>
-    setAgcAutoOn();
-
-    ResumableResult<void>
-    setLowDataRateOptimize();
-
-    virtual ResumableResult<void>
-    setOperationMode(Mode mode);
-
-    ResumableResult<void>
-    setCarrierFreq(uint8_t msb, uint8_t mid, uint8_t lsb);
-
-    ResumableResult<void>
-    setCarrierFreq(frequency_t freq);
-
-    ResumableResult<void>
-    setPaBoost();
-
-    ResumableResult<void>
-    setOutputPower(uint8_t power);
-
-    ResumableResult<void>
-    setBandwidth(SignalBandwidth bw);
-
-    ResumableResult<void>
-    setCodingRate(ErrorCodingRate cr);
-
-    ResumableResult<void>
-    setSpreadingFactor(SpreadingFactor sf);
-
-    ResumableResult<void>
-    setImplicitHeaderMode();
+protected:
+    void
+    countStep()
+    {}
+
+    void
+    countTransaction(uint8_t)
+    {}
+
+    void
+    countCsToggle()
+    {}
+};
 
-    ResumableResult<void>
-    setExplicitHeaderMode();
+/// Statistics policy of SX127x that counts the SPI cost of every access
+class SX127xStatistics
+{
+public:
+    struct Statistics
+    {
+        /// Number of register transactions (address byte + data)
+        uint32_t transactions;
+        /// Number of bytes clocked over the bus, address bytes included
+        uint32_t bytes;
+        /// Number of chip select edges
+        uint32_t csToggles;
+        /// Number of times an access primitive has been polled
+        uint32_t steps;
+    };
+
+    const Statistics&
+    getStatistics() const
+    { return statistics; }
+
+    void
+    resetStatistics()
+    { statistics = Statistics(); }
+
+protected:
+    void
+    countStep()
+    { statistics.steps++; }
+
+    void
+    countTransaction(uint8_t nbBytes)
+    {
+        statistics.transactions++;
+        statistics.bytes += 1 + nbBytes;
+    }
+
+    void
+    countCsToggle()
+    { statistics.csToggles++; }
 
-    ResumableResult<void>
-    setDio0Mapping(uint8_t map);
+private:
+    Statistics statistics = Statistics();
+};
 
-    ResumableResult<void>
-    enablePayloadCRC();
+/**
+ *  SPI access layer of the SX127x driver.
+ *
+ *  @tparam Statistics SX127xStatistics to count the bus cost of the
+ *                     driver, SX127xNoStatistics otherwise.
+ */
+template <typename SpiMaster, typename Cs, typename Statistics = SX127xNoStatistics>
+class SX127x : public SX127xCore, public SpiDevice<SpiMaster>, public Statistics
+{
+public:
+	SX127x();
 
+    // -- Basic I/O ------------------------------------------------------------
     ResumableResult<void>
-    setPayloadLength(uint8_t len);
+    write(Address addr, uint8_t data) override;
 
-    ResumableResult<bool>
-    getInterrupt(RegIrqFlags irq);
-
-    // -- Send/Receive ---------------------------------------------------------
     ResumableResult<void>
-    getPayload(uint8_t *data, uint8_t nbBytes);
+    write(Address addr, const uint8_t *data, uint8_t nbBytes) override;
 
     ResumableResult<void>
-    sendPacket(uint8_t *data, uint8_t nbBytes);
-
-private:
-    uint8_t value;
-    uint8_t buffer[4];
-    int32_t frequency;
-    RegAccess_t regAccess;
-
-    union Shadow {
-        RegOpMode_t regOpMode;
-        RegPaConfig_t regPaConfig;
-        RegLna_t regLna;
-        RegIrqFlagsMask_t regIrqFlagsMask;
-        RegIrqFlags_t regIrqFlags;
-        RegModemConfig1_t regModemConfig1;
-        RegModemConfig2_t regModemConfig2;
-        RegModemConfig3_t regModemConfig3;
-        RegDioMapping1_t regDioMapping1;
-
-        Shadow() {this->regOpMode.value = 0x00;}
-    } shadow;
+    read(Address addr, uint8_t *data, uint8_t nbBytes) override;
 };
 }
 
@@ -0,0 +1,108 @@
+#ifndef SX127X_ADDRESS_FILTER_HPP
+#define SX127X_ADDRESS_FILTER_HPP
+
+#include <modm/processing/resumable.hpp>
+
+#include "sx127x_core.hpp"
+
+namespace modm
+{
+
+/**
+ *  Header based address filter for frames received by a SX127x radio.
+ *
+ *  Each filter compares one header byte, `(frame[offset] & mask) ==
+ *  (address & mask)`. Filters on the same offset are alternatives, e.g. a
+ *  node address, a group address and the broadcast address, and a frame
+ *  passes if any of them matches. Filters on different offsets are all
+ *  required, e.g. a network id and a node address.
+ *
+ *  @tparam Filters Number of filter slots.
+ */
+template <uint8_t Filters = 2>
+class SX127xAddressFilter : public sx127x, protected NestedResumable<1>
+{
+public:
+    SX127xAddressFilter(SX127xCore &radio);
+
+    /**
+     *  Configures a filter slot, a mask of 0 disables it.
+     *
+     *  @param index   Filter slot, less than Filters.
+     *  @param offset  Position of the address byte in the frame, at most 254.
+     *  @param address Address to match.
+     *  @param mask    Bits of the address byte to compare.
+     *  @return `false` if the slot or the offset is out of range.
+     */
+    bool
+    setFilter(uint8_t index, uint8_t offset, uint8_t address, uint8_t mask);
+
+    void
+    clearFilter(uint8_t index);
+
+    /**
+     *  Number of received frames dropped by the filter in slot `index`.
+     *
+     *  Every dropped frame is counted once: filters are evaluated in slot
+     *  order per offset, and the drop is counted on the lowest slot using
+     *  the first offset none of whose filters matched. Frames too short to
+     *  contain that offset count as dropped there as well. The size of the
+     *  receive buffer does not matter, see getTruncations().
+     */
+    uint32_t
+    getDrops(uint8_t index) const;
+
+    /// Number of accepted frames that were longer than the receive buffer
+    uint32_t
+    getTruncations() const;
+
+    /**
+     *  Reads a received frame after RxDone, applying the filters.
+     *
+     *  Only the header bytes needed by the enabled filters are read first;
+     *  a rejected frame is dropped without reading its payload. The filters
+     *  see the complete frame, header bytes beyond `maxBytes` are read but
+     *  not stored to `data`.
+     *
+     *  @param data     Buffer for the frame.
+     *  @param maxBytes Size of `data`, longer frames are truncated.
+     *  @return Number of bytes read to `data`, 0 if the frame was dropped.
+     */
+    ResumableResult<uint8_t>
+    receive(uint8_t *data, uint8_t maxBytes);
+
+private:
+    struct Filter
+    {
+        uint8_t offset;
+        uint8_t address;
+        uint8_t mask;
+    };
+
+    /// Stores the header bytes at `offset` to `offset + count` a filter compares
+    void
+    sample(const uint8_t *bytes, uint8_t offset, uint8_t count);
+
+    /// @return Slot that rejected the frame, Filters if it was accepted
+    uint8_t
+    check(uint8_t available) const;
+
+    SX127xCore &radio;
+    Filter filters[Filters];
+    uint32_t drops[Filters];
+    uint32_t truncations;
+
+    uint8_t length;
+    uint8_t header;
+    uint8_t position;
+    uint8_t value;
+    /// Frame byte at the offset of each filter
+    uint8_t samples[Filters];
+    /// Header bytes that do not fit the receive buffer
+    uint8_t scratch[8];
+};
+}
+
+#include "sx127x_address_filter_impl.hpp"
+
+#endif
@@ -0,0 +1,191 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+namespace modm
+{
+
+template <uint8_t Filters>
+SX127xAddressFilter<Filters>::SX127xAddressFilter(SX127xCore &radio) :
+    radio(radio), filters(), drops(), truncations(0), length(0), header(0),
+    position(0), value(0), samples(), scratch()
+{
+
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Filters>
+bool
+SX127xAddressFilter<Filters>::setFilter(uint8_t index, uint8_t offset,
+                                        uint8_t address, uint8_t mask)
+{
+    // A frame holds at most 255 bytes, offset 255 can never match
+    if (index >= Filters or offset == 0xff) {
+        return false;
+    }
+
+    filters[index].offset = offset;
+    filters[index].address = address;
+    filters[index].mask = mask;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Filters>
+void
+SX127xAddressFilter<Filters>::clearFilter(uint8_t index)
+{
+    if (index < Filters) {
+        filters[index].mask = 0;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Filters>
+uint32_t
+SX127xAddressFilter<Filters>::getDrops(uint8_t index) const
+{
+    return index < Filters ? drops[index] : 0;
+}
+
+template <uint8_t Filters>
+uint32_t
+SX127xAddressFilter<Filters>::getTruncations() const
+{
+    return truncations;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Filters>
+void
+SX127xAddressFilter<Filters>::sample(const uint8_t *bytes, uint8_t offset, uint8_t count)
+{
+    for (uint8_t ii = 0; ii < Filters; ii++)
+    {
+        const Filter &filter = filters[ii];
+        if (filter.mask and filter.offset >= offset and filter.offset - offset < count) {
+            samples[ii] = bytes[filter.offset - offset];
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Filters>
+uint8_t
+SX127xAddressFilter<Filters>::check(uint8_t available) const
+{
+    for (uint8_t ii = 0; ii < Filters; ii++)
+    {
+        const Filter &filter = filters[ii];
+        if (not filter.mask) {
+            continue;
+        }
+
+        // Every offset is evaluated once, by the first filter using it
+        bool evaluated = false;
+        for (uint8_t jj = 0; jj < ii; jj++) {
+            evaluated |= filters[jj].mask and filters[jj].offset == filter.offset;
+        }
+        if (evaluated) {
+            continue;
+        }
+        if (filter.offset >= available) {
+            return ii;
+        }
+
+        bool match = false;
+        for (uint8_t jj = ii; jj < Filters; jj++)
+        {
+            const Filter &other = filters[jj];
+            if (other.mask and other.offset == filter.offset and
+                (samples[jj] & other.mask) == (other.address & other.mask))
+            {
+                match = true;
+            }
+        }
+        if (not match) {
+            return ii;
+        }
+    }
+    return Filters;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Filters>
+ResumableResult<uint8_t>
+SX127xAddressFilter<Filters>::receive(uint8_t *data, uint8_t maxBytes)
+{
+    RF_BEGIN();
+
+    // Clear RxDone interrupt flag
+    RF_CALL(radio.write(Address::IrqFlags, (uint8_t) RegIrqFlags::RxDone));
+
+    // Filters see the whole frame, independent of the buffer size
+    RF_CALL(radio.read(Address::RxNbBytes, &(length), 1));
+
+    // Set Fifo address pointer to payload address
+    RF_CALL(radio.read(Address::FifoRxCurrAddr, &(value), 1));
+    RF_CALL(radio.write(Address::FifoAddrPtr, value));
+
+    // Read only as much of the header as the filters need
+    header = 0;
+    for (const Filter &filter : filters)
+    {
+        if (filter.mask and filter.offset >= header) {
+            header = filter.offset + 1;
+        }
+    }
+    if (header > length) {
+        header = length;
+    }
+
+    // The part of the header that fits is read to the buffer in place
+    position = header < maxBytes ? header : maxBytes;
+    if (position > 0)
+    {
+        RF_CALL(radio.read(Address::Fifo, data, position));
+        sample(data, 0, position);
+    }
+
+    // the rest only passes the scratch buffer
+    while (position < header)
+    {
+        value = header - position;
+        if (value > sizeof(scratch)) {
+            value = sizeof(scratch);
+        }
+        RF_CALL(radio.read(Address::Fifo, scratch, value));
+        sample(scratch, position, value);
+        position += value;
+    }
+
+    value = check(length);
+    if (value < Filters) {
+        drops[value]++;
+        length = 0;
+    } else if (length > maxBytes) {
+        truncations++;
+        length = maxBytes;
+    }
+
+    // Read the remaining payload of accepted frames
+    if (length > position) {
+        RF_CALL(radio.read(Address::Fifo, data + position, length - position));
+    }
+
+    // Reset Fifo address pointer
+    RF_CALL(radio.read(Address::FifoRxBaseAddr, &(value), 1));
+    RF_CALL(radio.write(Address::FifoAddrPtr, value));
+
+    RF_END_RETURN(length);
+};
+
+} // end namespace modm
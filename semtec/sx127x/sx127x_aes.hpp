@@ -0,0 +1,58 @@
+#ifndef SX127X_AES_HPP
+#define SX127X_AES_HPP
+
+#include <stdint.h>
+
+namespace modm
+{
+
+/**
+ *  Table driven software AES-128 block encryption.
+ *
+ *  Backend for SX127xCcm, only the forward cipher is needed. A hardware
+ *  backend has to provide the same interface:
+ *  `setKey(const uint8_t *key)` and `encrypt(uint8_t *block)`.
+ *
+ *  Only uses the 256 byte S-box, see SX127xAesTable for a faster backend.
+ */
+class SX127xAesSoftware
+{
+public:
+    static constexpr uint8_t BlockSize = 16;
+
+    void
+    setKey(const uint8_t *key);
+
+    /// Encrypts one block of 16 bytes in place
+    void
+    encrypt(uint8_t *block) const;
+
+private:
+    uint8_t roundKeys[11 * BlockSize];
+};
+
+/**
+ *  Software AES-128 block encryption on 32 bit words.
+ *
+ *  Combines SubBytes and MixColumns in a 1 KiB lookup table, which trades
+ *  flash for speed on 32 bit cores. Same interface as SX127xAesSoftware.
+ */
+class SX127xAesTable
+{
+public:
+    static constexpr uint8_t BlockSize = 16;
+
+    void
+    setKey(const uint8_t *key);
+
+    /// Encrypts one block of 16 bytes in place
+    void
+    encrypt(uint8_t *block) const;
+
+private:
+    uint32_t roundKeys[11 * 4];
+};
+
+}
+
+#endif
@@ -0,0 +1,447 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "sx127x_async.hpp"
+
+namespace modm
+{
+
+SX127xAsync::SX127xAsync(SX127xCore &core) :
+    core(core)
+{
+
+}
+
+// ----------------------------------------------------------------------------
+
+bool
+SX127xAsync::Access::poll()
+{
+    ResumableResult<void> result =
+        not write ? core.read(addr, data, nbBytes) :
+        data ? core.write(addr, data, nbBytes) : core.write(addr, value);
+    return result.getState() > rf::NestingError;
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xCore&
+SX127xAsync::getCore()
+{
+    return core;
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::initialize()
+{
+    co_return;
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::write(Address addr, uint8_t data)
+{
+    co_await writeRegister(addr, data);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::write(Address addr, const uint8_t *data, uint8_t nbBytes)
+{
+    co_await writeRegister(addr, data, nbBytes);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::read(Address addr, uint8_t *data, uint8_t nbBytes)
+{
+    co_await readRegister(addr, data, nbBytes);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setLora()
+{
+    RegOpMode_t regOpMode;
+
+    /// Put module into sleep mode in order to set LoRa Mode
+    co_await readRegister(Address::OpMode, &(regOpMode.value), 1);
+
+    Mode_t::set(regOpMode, Mode::Sleep);
+
+    co_await writeRegister(Address::OpMode, regOpMode.value);
+    core.recordOpMode(regOpMode);
+
+    /// Set operation mode to LoRa mode
+    regOpMode.set(RegOpMode::LongRangeMode);
+    regOpMode.reset(RegOpMode::AccessSharedReg);
+
+    co_await writeRegister(Address::OpMode, regOpMode.value);
+    core.recordOpMode(regOpMode);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setLowFrequencyMode()
+{
+    RegOpMode_t regOpMode;
+
+    co_await readRegister(Address::OpMode, &(regOpMode.value), 1);
+
+    regOpMode.set(RegOpMode::LowFrequencyModeOn);
+
+    co_await writeRegister(Address::OpMode, regOpMode.value);
+    core.recordOpMode(regOpMode);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setHighFrequencyMode()
+{
+    RegOpMode_t regOpMode;
+
+    co_await readRegister(Address::OpMode, &(regOpMode.value), 1);
+
+    regOpMode.reset(RegOpMode::LowFrequencyModeOn);
+
+    co_await writeRegister(Address::OpMode, regOpMode.value);
+    core.recordOpMode(regOpMode);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setLnaGain(uint8_t gain)
+{
+    RegLna_t regLna;
+
+    co_await readRegister(Address::Lna, &(regLna.value), 1);
+
+    LnaGain_t::set(regLna, gain);
+
+    co_await writeRegister(Address::Lna, regLna.value);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setLnaBoostHf()
+{
+    RegLna_t regLna;
+
+    co_await readRegister(Address::Lna, &(regLna.value), 1);
+
+    LnaBoostHf_t::set(regLna, 0x03);
+
+    co_await writeRegister(Address::Lna, regLna.value);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setAgcAutoOn()
+{
+    RegModemConfig3_t regModemConfig3;
+
+    co_await readRegister(Address::ModemConfig3, &(regModemConfig3.value), 1);
+
+    regModemConfig3.set(RegModemConfig3::AgcAutoOn);
+
+    co_await writeRegister(Address::ModemConfig3, regModemConfig3.value);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setLowDataRateOptimize()
+{
+    RegModemConfig3_t regModemConfig3;
+
+    co_await readRegister(Address::ModemConfig3, &(regModemConfig3.value), 1);
+
+    regModemConfig3.set(RegModemConfig3::LowDataRateOptimize);
+
+    co_await writeRegister(Address::ModemConfig3, regModemConfig3.value);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setOperationMode(Mode mode)
+{
+    RegOpMode_t regOpMode;
+
+    co_await readRegister(Address::OpMode, &(regOpMode.value), 1);
+
+    Mode_t::set(regOpMode, mode);
+
+    co_await writeRegister(Address::OpMode, regOpMode.value);
+    core.recordOpMode(regOpMode);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::writeOpMode(RegOpMode_t opMode)
+{
+    co_await writeRegister(Address::OpMode, opMode.value);
+    core.recordOpMode(opMode);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setCarrierFreq(uint8_t msb, uint8_t mid, uint8_t lsb)
+{
+    // Frf may only be changed in sleep or standby mode
+    co_await setOperationMode(Mode::Standby);
+
+    // write the three frequency bytes (MSB->LSB) in one burst
+    const uint8_t frf[3] = {msb, mid, lsb};
+    co_await writeRegister(Address::FrMsb, frf, 3);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setCarrierFreq(frequency_t freq)
+{
+    // Frf may only be changed in sleep or standby mode
+    co_await setOperationMode(Mode::Standby);
+
+    // write the three frequency bytes (MSB->LSB)
+    const Frf frf = toFrf(freq);
+    co_await writeRegister(Address::FrMsb, frf.value, 3);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setPaBoost()
+{
+    RegPaConfig_t regPaConfig;
+
+    co_await readRegister(Address::PaConfig, &(regPaConfig.value), 1);
+
+    regPaConfig.set(RegPaConfig::PaSelect);
+
+    co_await writeRegister(Address::PaConfig, regPaConfig.value);
+    core.recordPaConfig(regPaConfig);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setOutputPower(uint8_t power)
+{
+    RegPaConfig_t regPaConfig;
+
+    co_await readRegister(Address::PaConfig, &(regPaConfig.value), 1);
+
+    OutputPower_t::set(regPaConfig, power);
+
+    co_await writeRegister(Address::PaConfig, regPaConfig.value);
+    core.recordPaConfig(regPaConfig);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setBandwidth(SignalBandwidth bw)
+{
+    RegModemConfig1_t regModemConfig1;
+
+    co_await readRegister(Address::ModemConfig1, &(regModemConfig1.value), 1);
+
+    SignalBandwidth_t::set(regModemConfig1, bw);
+
+    co_await writeRegister(Address::ModemConfig1, regModemConfig1.value);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setCodingRate(ErrorCodingRate cr)
+{
+    RegModemConfig1_t regModemConfig1;
+
+    co_await readRegister(Address::ModemConfig1, &(regModemConfig1.value), 1);
+
+    ErrorCodingRate_t::set(regModemConfig1, cr);
+
+    co_await writeRegister(Address::ModemConfig1, regModemConfig1.value);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setSpreadingFactor(SpreadingFactor sf)
+{
+    RegModemConfig2_t regModemConfig2;
+
+    co_await readRegister(Address::ModemConfig2, &(regModemConfig2.value), 1);
+
+    SpreadingFactor_t::set(regModemConfig2, sf);
+
+    co_await writeRegister(Address::ModemConfig2, regModemConfig2.value);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setImplicitHeaderMode()
+{
+    RegModemConfig1_t regModemConfig1;
+
+    co_await readRegister(Address::ModemConfig1, &(regModemConfig1.value), 1);
+
+    regModemConfig1.set(RegModemConfig1::ImplicitHeaderModeOn);
+
+    co_await writeRegister(Address::ModemConfig1, regModemConfig1.value);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setExplicitHeaderMode()
+{
+    RegModemConfig1_t regModemConfig1;
+
+    co_await readRegister(Address::ModemConfig1, &(regModemConfig1.value), 1);
+
+    regModemConfig1.reset(RegModemConfig1::ImplicitHeaderModeOn);
+
+    co_await writeRegister(Address::ModemConfig1, regModemConfig1.value);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setDio0Mapping(uint8_t map)
+{
+    RegDioMapping1_t regDioMapping1;
+
+    co_await readRegister(Address::DioMapping1, &(regDioMapping1.value), 1);
+
+    Dio0Mapping_t::set(regDioMapping1, map);
+
+    co_await writeRegister(Address::DioMapping1, regDioMapping1.value);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::enablePayloadCRC()
+{
+    RegModemConfig2_t regModemConfig2;
+
+    co_await readRegister(Address::ModemConfig2, &(regModemConfig2.value), 1);
+
+    regModemConfig2.set(RegModemConfig2::RxPayloadCrcOn);
+
+    co_await writeRegister(Address::ModemConfig2, regModemConfig2.value);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::setPayloadLength(uint8_t len)
+{
+    co_await writeRegister(Address::PayloadLength, len);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<bool>
+SX127xAsync::getInterrupt(RegIrqFlags irq)
+{
+    RegIrqFlags_t regIrqFlags;
+
+    co_await readRegister(Address::IrqFlags, &(regIrqFlags.value), 1);
+    core.recordIrqFlags(regIrqFlags);
+
+    co_return bool(regIrqFlags & irq);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::getPayload(uint8_t *data, uint8_t nbBytes)
+{
+    // FifoRxBaseAddr and FifoRxCurrAddr, adjacent registers read in one burst
+    uint8_t addr[2];
+
+    // Clear RxDone interrupt flag
+    co_await writeRegister(Address::IrqFlags, (uint8_t) RegIrqFlags::RxDone);
+
+    // Set Fifo address pointer to payload address
+    co_await readRegister(Address::FifoRxBaseAddr, addr, 2);
+    co_await writeRegister(Address::FifoAddrPtr, addr[1]);
+
+    // Read payload
+    co_await readRegister(Address::Fifo, data, nbBytes);
+
+    // Reset Fifo address pointer
+    co_await writeRegister(Address::FifoAddrPtr, addr[0]);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::sendPacket(uint8_t *data, uint8_t nbBytes)
+{
+    uint8_t addr;
+
+    // Clear TxDone interrupt flag
+    co_await writeRegister(Address::IrqFlags, (uint8_t) RegIrqFlags::TxDone);
+
+    // Set Fifo address pointer to base address
+    co_await readRegister(Address::FifoTxBaseAddr, &addr, 1);
+    co_await writeRegister(Address::FifoAddrPtr, addr);
+
+    // Write payload to Fifo
+    co_await writeRegister(Address::Fifo, data, nbBytes);
+
+    // Send the package
+    co_await setOperationMode(Mode::Transmit);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::loadPacket(const uint8_t *data, uint8_t nbBytes)
+{
+    uint8_t addr;
+
+    // Clear TxDone interrupt flag
+    co_await writeRegister(Address::IrqFlags, (uint8_t) RegIrqFlags::TxDone);
+
+    // Set Fifo address pointer to base address
+    co_await readRegister(Address::FifoTxBaseAddr, &addr, 1);
+    co_await writeRegister(Address::FifoAddrPtr, addr);
+
+    // Write payload to Fifo, replacing any previously loaded packet
+    co_await writeRegister(Address::Fifo, data, nbBytes);
+    co_await writeRegister(Address::PayloadLength, nbBytes);
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xTask<>
+SX127xAsync::startTransmit()
+{
+    co_await setOperationMode(Mode::Transmit);
+}
+
+} // end namespace modm
@@ -0,0 +1,191 @@
+#ifndef SX127X_ASYNC_HPP
+#define SX127X_ASYNC_HPP
+
+#include <modm/math/units.hpp>
+
+#include "sx127x_core.hpp"
+#include "sx127x_task.hpp"
+
+namespace modm
+{
+
+/**
+ *  C++20 coroutine front-end of the SX127x driver.
+ *
+ *  Every operation of SX127xCore is available as a SX127xTask on the same
+ *  register definitions. Only the access primitives read() and write() of
+ *  the core are awaited, the protocol logic runs in the coroutine: OpMode,
+ *  Frf and the Fifo addresses are locals of the frame instead of the shadow
+ *  registers of the core, and operations nest without a nesting limit.
+ *  Observers of the core are notified like by the resumable functions.
+ *
+ *  Like two resumable functions of the core, two operations of the same
+ *  radio must not access its registers at the same time.
+ *
+ *  @code
+ *  SX127x<SpiMaster, Cs> core;
+ *  SX127xAsync radio(core);
+ *
+ *  auto task = radio.sendPacket(data, sizeof(data));
+ *  while (task.update()) {
+ *      // do other work
+ *  }
+ *  @endcode
+ */
+class SX127xAsync : public sx127x
+{
+public:
+    explicit SX127xAsync(SX127xCore &core);
+
+    SX127xTask<>
+    initialize();
+
+    // -- Basic I/O ------------------------------------------------------------
+    SX127xTask<>
+    write(Address addr, uint8_t data);
+
+    SX127xTask<>
+    write(Address addr, const uint8_t *data, uint8_t nbBytes);
+
+    SX127xTask<>
+    read(Address addr, uint8_t *data, uint8_t nbBytes);
+
+    // -- Advanced I/O ---------------------------------------------------------
+    SX127xTask<>
+    setLora();
+
+    SX127xTask<>
+    setLowFrequencyMode();
+
+    SX127xTask<>
+    setHighFrequencyMode();
+
+    SX127xTask<>
+    setLnaGain(uint8_t gain);
+
+    SX127xTask<>
+    setLnaBoostHf();
+
+    SX127xTask<>
+    setAgcAutoOn();
+
+    SX127xTask<>
+    setLowDataRateOptimize();
+
+    SX127xTask<>
+    setOperationMode(Mode mode);
+
+    SX127xTask<>
+    writeOpMode(RegOpMode_t opMode);
+
+    SX127xTask<>
+    setCarrierFreq(uint8_t msb, uint8_t mid, uint8_t lsb);
+
+    SX127xTask<>
+    setCarrierFreq(frequency_t freq);
+
+    SX127xTask<>
+    setPaBoost();
+
+    SX127xTask<>
+    setOutputPower(uint8_t power);
+
+    SX127xTask<>
+    setBandwidth(SignalBandwidth bw);
+
+    SX127xTask<>
+    setCodingRate(ErrorCodingRate cr);
+
+    SX127xTask<>
+    setSpreadingFactor(SpreadingFactor sf);
+
+    SX127xTask<>
+    setImplicitHeaderMode();
+
+    SX127xTask<>
+    setExplicitHeaderMode();
+
+    SX127xTask<>
+    setDio0Mapping(uint8_t map);
+
+    SX127xTask<>
+    enablePayloadCRC();
+
+    SX127xTask<>
+    setPayloadLength(uint8_t len);
+
+    SX127xTask<bool>
+    getInterrupt(RegIrqFlags irq);
+
+    // -- Send/Receive ---------------------------------------------------------
+    SX127xTask<>
+    getPayload(uint8_t *data, uint8_t nbBytes);
+
+    SX127xTask<>
+    sendPacket(uint8_t *data, uint8_t nbBytes);
+
+    SX127xTask<>
+    loadPacket(const uint8_t *data, uint8_t nbBytes);
+
+    SX127xTask<>
+    startTransmit();
+
+    SX127xCore&
+    getCore();
+
+private:
+    /// Awaits one access primitive of the core without a frame of its own
+    class Access : public SX127xPollable
+    {
+    public:
+        Access(SX127xCore &core, Address addr, uint8_t *data, uint8_t nbBytes, bool write) :
+            core(core), data(data), addr(addr), nbBytes(nbBytes), value(0), write(write)
+        {}
+
+        Access(SX127xCore &core, Address addr, uint8_t value) :
+            core(core), data(nullptr), addr(addr), nbBytes(1), value(value), write(true)
+        {}
+
+        bool
+        poll() override;
+
+        bool
+        await_ready()
+        { return not poll(); }
+
+        template <typename Promise>
+        void
+        await_suspend(std::coroutine_handle<Promise> handle)
+        { handle.promise().pending = this; }
+
+        void
+        await_resume()
+        {}
+
+    private:
+        SX127xCore &core;
+        uint8_t *data;
+        Address addr;
+        uint8_t nbBytes;
+        uint8_t value;
+        bool write;
+    };
+
+    Access
+    writeRegister(Address addr, uint8_t data)
+    { return Access(core, addr, data); }
+
+    Access
+    readRegister(Address addr, uint8_t *data, uint8_t nbBytes)
+    { return Access(core, addr, data, nbBytes, false); }
+
+    /// The data is only read, Access keeps a single pointer for both directions
+    Access
+    writeRegister(Address addr, const uint8_t *data, uint8_t nbBytes)
+    { return Access(core, addr, const_cast<uint8_t*>(data), nbBytes, true); }
+
+    SX127xCore &core;
+};
+}
+
+#endif
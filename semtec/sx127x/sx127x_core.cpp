@@ -0,0 +1,544 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "sx127x_core.hpp"
+
+namespace modm
+{
+
+SX127xCore::SX127xCore() :
+    observer(nullptr), fifoEpoch(0)
+{
+
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xCore::setObserver(SX127xObserver *observer)
+{
+    this->observer = observer;
+}
+
+// ----------------------------------------------------------------------------
+
+uint8_t
+SX127xCore::getFifoEpoch() const
+{
+    return fifoEpoch;
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xCore::recordOpMode(RegOpMode_t opMode)
+{
+    if (Mode_t::get(opMode) == Mode::Sleep) {
+        fifoEpoch++;
+    }
+    if (observer) {
+        observer->onOpMode(opMode);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xCore::recordPaConfig(RegPaConfig_t paConfig)
+{
+    if (observer) {
+        observer->onPaConfig(paConfig);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xCore::recordIrqFlags(RegIrqFlags_t irqFlags)
+{
+    if (observer) {
+        observer->onIrqFlags(irqFlags);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::initialize()
+{
+    RF_BEGIN();
+
+    RF_END();
+}
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setLora()
+{
+    RF_BEGIN();
+
+    /// Put module into sleep mode in order to set LoRa Mode
+    RF_CALL(read(Address::OpMode, &((shadow.regOpMode).value), 1));
+
+    Mode_t::set(shadow.regOpMode, Mode::Sleep);
+
+    RF_CALL(write(Address::OpMode, shadow.regOpMode.value));
+    recordOpMode(shadow.regOpMode);
+
+    /// Set operation mode to LoRa mode
+    shadow.regOpMode.set(RegOpMode::LongRangeMode);
+    shadow.regOpMode.reset(RegOpMode::AccessSharedReg);    
+
+    RF_CALL(write(Address::OpMode, shadow.regOpMode.value));
+    recordOpMode(shadow.regOpMode);
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setLowFrequencyMode()
+{
+    RF_BEGIN();
+
+    // Read current configuration and set LowFrequencyMode to 1
+    RF_CALL(read(Address::OpMode, &((shadow.regOpMode).value), 1));
+
+    shadow.regOpMode.set(RegOpMode::LowFrequencyModeOn);
+
+    RF_CALL(write(Address::OpMode, shadow.regOpMode.value));
+    recordOpMode(shadow.regOpMode);
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setHighFrequencyMode()
+{
+    RF_BEGIN();
+
+    // Read current configuration and set LowFrequencyMode to 1
+    RF_CALL(read(Address::OpMode, &((shadow.regOpMode).value), 1));
+
+    shadow.regOpMode.reset(RegOpMode::LowFrequencyModeOn);
+
+    RF_CALL(write(Address::OpMode, shadow.regOpMode.value));
+    recordOpMode(shadow.regOpMode);
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setOperationMode(Mode mode)
+{
+    RF_BEGIN();
+
+    // Read current configuration and set LowFrequencyMode to 1
+    RF_CALL(read(Address::OpMode, &((shadow.regOpMode).value), 1));
+
+    Mode_t::set(shadow.regOpMode, mode);
+
+    RF_CALL(write(Address::OpMode, shadow.regOpMode.value));
+    recordOpMode(shadow.regOpMode);
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::writeOpMode(RegOpMode_t opMode)
+{
+    RF_BEGIN();
+
+    shadow.regOpMode = opMode;
+
+    RF_CALL(write(Address::OpMode, shadow.regOpMode.value));
+    recordOpMode(shadow.regOpMode);
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setCarrierFreq(uint8_t msb, uint8_t mid, uint8_t lsb)
+{
+    RF_BEGIN();
+
+    // Read current configuration and set operation mode to 'sleep'
+    RF_CALL(read(Address::OpMode, &((shadow.regOpMode).value), 1));
+
+    Mode_t::set(shadow.regOpMode, Mode::Standby);
+
+    RF_CALL(write(Address::OpMode, shadow.regOpMode.value));
+    recordOpMode(shadow.regOpMode);
+
+    // write the three frequency bytes (MSB->LSB)
+    RF_CALL(write(Address::FrMsb, msb));
+    RF_CALL(write(Address::FrMid, mid));
+    RF_CALL(write(Address::FrLsb, lsb));
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setCarrierFreq(frequency_t freq)
+{
+    RF_BEGIN();
+
+    // Read current configuration and set operation mode to 'sleep'
+    RF_CALL(read(Address::OpMode, &((shadow.regOpMode).value), 1));
+
+    Mode_t::set(shadow.regOpMode, Mode::Standby);
+
+    RF_CALL(write(Address::OpMode, shadow.regOpMode.value));
+    recordOpMode(shadow.regOpMode);
+
+    // OpMode is written, its shadow is free for the frequency bytes
+    shadow.frf = toFrf(freq);
+
+    // write the three frequency bytes (MSB->LSB)
+    RF_CALL(write(Address::FrMsb, shadow.frf.value, 3));
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setLnaGain(uint8_t gain)
+{
+    RF_BEGIN();
+
+    // Read current configuration
+    RF_CALL(read(Address::Lna, &((shadow.regLna).value), 1));
+
+    LnaGain_t::set(shadow.regLna, gain);
+
+    RF_CALL(write(Address::Lna, shadow.regLna.value));
+
+    RF_END();
+};
+
+ResumableResult<void>
+SX127xCore::setLnaBoostHf()
+{
+    RF_BEGIN();
+
+    // Read current configuration
+    RF_CALL(read(Address::Lna, &((shadow.regLna).value), 1));
+
+    LnaBoostHf_t::set(shadow.regLna, 0x03);
+
+    RF_CALL(write(Address::Lna, shadow.regLna.value));
+
+    RF_END();
+}
+
+// ----------------------------------------------------------------------------
+ResumableResult<void>
+SX127xCore::setAgcAutoOn()
+{
+    RF_BEGIN();
+    // Read current configuration
+    RF_CALL(read(Address::ModemConfig3, &((shadow.regModemConfig3).value), 1));
+
+    shadow.regModemConfig3.set(RegModemConfig3::AgcAutoOn);
+
+    RF_CALL(write(Address::ModemConfig3, shadow.regModemConfig3.value));
+
+    RF_END();
+}
+
+// ----------------------------------------------------------------------------
+ResumableResult<void>
+SX127xCore::setLowDataRateOptimize()
+{
+    RF_BEGIN();
+    // Read current configuration
+    RF_CALL(read(Address::ModemConfig3, &((shadow.regModemConfig3).value), 1));
+
+    shadow.regModemConfig3.set(RegModemConfig3::LowDataRateOptimize);
+
+    RF_CALL(write(Address::ModemConfig3, shadow.regModemConfig3.value));
+
+    RF_END();
+}
+
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setPaBoost()
+{
+    RF_BEGIN();
+
+    // Read current configuration
+    RF_CALL(read(Address::PaConfig, &((shadow.regPaConfig).value), 1));
+
+    shadow.regPaConfig.set(RegPaConfig::PaSelect);
+
+    RF_CALL(write(Address::PaConfig, shadow.regPaConfig.value));
+    recordPaConfig(shadow.regPaConfig);
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setOutputPower(uint8_t power)
+{
+    RF_BEGIN();
+
+    // Read current configuration and set operation mode to 'standby'
+    RF_CALL(read(Address::PaConfig, &((shadow.regPaConfig).value), 1));
+
+    OutputPower_t::set(shadow.regPaConfig, power);
+
+    RF_CALL(write(Address::PaConfig, shadow.regPaConfig.value));
+    recordPaConfig(shadow.regPaConfig);
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setBandwidth(SignalBandwidth bw)
+{
+    RF_BEGIN();
+
+    RF_CALL(read(Address::ModemConfig1, &((shadow.regModemConfig1).value), 1));
+
+    SignalBandwidth_t::set(shadow.regModemConfig1, bw);
+
+    RF_CALL(write(Address::ModemConfig1, shadow.regModemConfig1.value));
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setCodingRate(ErrorCodingRate cr)
+{
+    RF_BEGIN();
+
+    RF_CALL(read(Address::ModemConfig1, &((shadow.regModemConfig1).value), 1));
+
+    ErrorCodingRate_t::set(shadow.regModemConfig1, cr);
+
+    RF_CALL(write(Address::ModemConfig1, shadow.regModemConfig1.value));
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setSpreadingFactor(SpreadingFactor sf)
+{
+    RF_BEGIN();
+
+    RF_CALL(read(Address::ModemConfig2, &((shadow.regModemConfig2).value), 1));
+
+    SpreadingFactor_t::set(shadow.regModemConfig2, sf);
+
+    RF_CALL(write(Address::ModemConfig2, shadow.regModemConfig2.value));
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setImplicitHeaderMode()
+{
+    RF_BEGIN();
+
+    RF_CALL(read(Address::ModemConfig1, &((shadow.regModemConfig1).value), 1));
+
+    shadow.regModemConfig1.set(RegModemConfig1::ImplicitHeaderModeOn);
+
+    RF_CALL(write(Address::ModemConfig1, shadow.regModemConfig1.value));
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setExplicitHeaderMode()
+{
+    RF_BEGIN();
+
+    RF_CALL(read(Address::ModemConfig1, &((shadow.regModemConfig1).value), 1));
+
+    shadow.regModemConfig1.reset(RegModemConfig1::ImplicitHeaderModeOn);
+
+    RF_CALL(write(Address::ModemConfig1, shadow.regModemConfig1.value));
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setDio0Mapping(uint8_t map)
+{
+    RF_BEGIN();
+
+    RF_CALL(read(Address::DioMapping1, &((shadow.regDioMapping1).value), 1));
+
+    Dio0Mapping_t::set(shadow.regDioMapping1, map);
+
+    RF_CALL(write(Address::DioMapping1, shadow.regDioMapping1.value));
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::enablePayloadCRC()
+{
+    RF_BEGIN();
+
+    RF_CALL(read(Address::ModemConfig2, &((shadow.regModemConfig2).value), 1));
+
+    shadow.regModemConfig2.set(RegModemConfig2::RxPayloadCrcOn);
+
+    RF_CALL(write(Address::ModemConfig2, shadow.regModemConfig2.value));
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::setPayloadLength(uint8_t len)
+{
+    RF_BEGIN();
+
+    RF_CALL(write(Address::PayloadLength, len));
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<bool>
+SX127xCore::getInterrupt(RegIrqFlags irq)
+{
+    RF_BEGIN();
+
+    RF_CALL(read(Address::IrqFlags, &((shadow.regIrqFlags).value), 1));
+
+    recordIrqFlags(shadow.regIrqFlags);
+
+    RF_END_RETURN(shadow.regIrqFlags & irq);
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::getPayload(uint8_t *data, uint8_t nbBytes)
+{
+    RF_BEGIN();
+
+    // Clear RxDone interrupt flag
+    RF_CALL(write(Address::IrqFlags, (uint8_t) RegIrqFlags::RxDone));
+
+    // Set Fifo address pointer to payload address
+    RF_CALL(read(Address::FifoRxCurrAddr, &(value), 1));
+    RF_CALL(write(Address::FifoAddrPtr, value));
+
+    // Read payload
+    RF_CALL(read(Address::Fifo, data, nbBytes));
+
+    // Reset Fifo address pointer
+    RF_CALL(read(Address::FifoRxBaseAddr, &(value), 1));
+    RF_CALL(write(Address::FifoAddrPtr, value));
+
+    // Todo: Check for incoming package before resetting the Addr pointer
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::sendPacket(uint8_t *data, uint8_t nbBytes)
+{
+    RF_BEGIN();
+
+    // Clear TxDone interrupt flag
+    RF_CALL(write(Address::IrqFlags, (uint8_t) RegIrqFlags::TxDone));
+
+    // Set Fifo address pointer to base address
+    RF_CALL(read(Address::FifoTxBaseAddr, &(value), 1));
+    RF_CALL(write(Address::FifoAddrPtr, value));
+
+    // Write payload to Fifo
+    RF_CALL(write(Address::Fifo, data, nbBytes));
+
+    // Send the package, mode change inlined to stay within two nesting levels
+    RF_CALL(read(Address::OpMode, &((shadow.regOpMode).value), 1));
+    Mode_t::set(shadow.regOpMode, Mode::Transmit);
+    RF_CALL(write(Address::OpMode, shadow.regOpMode.value));
+    recordOpMode(shadow.regOpMode);
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::loadPacket(const uint8_t *data, uint8_t nbBytes)
+{
+    RF_BEGIN();
+
+    // Clear TxDone interrupt flag
+    RF_CALL(write(Address::IrqFlags, (uint8_t) RegIrqFlags::TxDone));
+
+    // Set Fifo address pointer to base address
+    RF_CALL(read(Address::FifoTxBaseAddr, &(value), 1));
+    RF_CALL(write(Address::FifoAddrPtr, value));
+
+    // Write payload to Fifo, replacing any previously loaded packet
+    RF_CALL(write(Address::Fifo, data, nbBytes));
+    RF_CALL(write(Address::PayloadLength, nbBytes));
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xCore::startTransmit()
+{
+    RF_BEGIN();
+
+    // Mode change inlined to stay within two nesting levels
+    RF_CALL(read(Address::OpMode, &((shadow.regOpMode).value), 1));
+    Mode_t::set(shadow.regOpMode, Mode::Transmit);
+    RF_CALL(write(Address::OpMode, shadow.regOpMode.value));
+    recordOpMode(shadow.regOpMode);
+
+    RF_END();
+};
+
+} // end namespace modm
\ No newline at end of file
@@ -0,0 +1,238 @@
+#ifndef SX127X_CORE_HPP
+#define SX127X_CORE_HPP
+
+#include <modm/math/units.hpp>
+#include <modm/processing/resumable.hpp>
+
+#include "sx127x_definitions.hpp"
+
+namespace modm
+{
+
+/**
+ *  Receives the register contents that determine the power state of a
+ *  SX127x, e.g. to account its energy consumption.
+ *
+ *  The radio returns to standby mode on its own after TxDone, after RxDone
+ *  or RxTimeout in single receive mode and after CadDone. onIrqFlags()
+ *  reports the flags read by SX127xCore::getInterrupt() for that purpose.
+ */
+class SX127xObserver
+{
+public:
+    /// Called after every OpMode write with the written value
+    virtual void
+    onOpMode(sx127x::RegOpMode_t)
+    {}
+
+    /// Called after every PaConfig write with the written value
+    virtual void
+    onPaConfig(sx127x::RegPaConfig_t)
+    {}
+
+    /// Called with the interrupt flags read by getInterrupt()
+    virtual void
+    onIrqFlags(sx127x::RegIrqFlags_t)
+    {}
+
+protected:
+    ~SX127xObserver() = default;
+};
+
+/**
+ *  Bus independent part of the SX127x driver.
+ *
+ *  Holds the register encoding and protocol logic once for all radios, only
+ *  the register access primitives are implemented by the SPI/CS specific
+ *  SX127x template.
+ *
+ *  The protocol functions only call the access primitives, never each
+ *  other, so two resumable nesting levels are sufficient.
+ */
+class SX127xCore : public sx127x, protected NestedResumable<2>
+{
+public:
+	SX127xCore();
+
+    ///
+	ResumableResult<void>
+	initialize();
+
+    // -- Basic I/O ------------------------------------------------------------
+
+    /**
+     *  Write access to specified SX127x register.
+     *
+     *  Writes exactly one byte of data to the register specified by it's
+     *  address.
+     *
+     *  @param addr Address of the register to write to.
+     *  @param data Databyte to write to the specified address.
+     */
+    virtual ResumableResult<void>
+    write(Address addr, uint8_t data) = 0;
+
+    virtual ResumableResult<void>
+    write(Address addr, const uint8_t *data, uint8_t nbBytes) = 0;
+
+    virtual ResumableResult<void>
+    read(Address addr, uint8_t *data, uint8_t nbBytes) = 0;
+
+    // -- Advanced I/O ---------------------------------------------------------
+    ResumableResult<void>
+    setLora();
+
+    //xpcc::ResumableResult<void>
+    //setFSK();
+
+    ResumableResult<void>
+    setLowFrequencyMode();
+
+    ResumableResult<void>
+    setHighFrequencyMode();
+
+    ResumableResult<void>
+    setLnaGain(uint8_t gain);
+
+    ResumableResult<void>
+    setLnaBoostHf();
+
+    //xpcc::ResumableResult<void>
+    //setHighFrequencyMode();
+    ResumableResult<void>
+    setAgcAutoOn();
+
+    ResumableResult<void>
+    setLowDataRateOptimize();
+
+    /**
+     *  Changes the mode with a read-modify-write of OpMode.
+     *
+     *  Not virtual: sendPacket() and startTransmit() change the mode
+     *  without calling it. Use SX127xObserver::onOpMode() to follow every
+     *  mode change.
+     */
+    ResumableResult<void>
+    setOperationMode(Mode mode);
+
+    /**
+     *  Writes the complete OpMode register without reading it first.
+     *
+     *  For helpers that already know the remaining OpMode bits and need
+     *  mode changes to cost a single register write.
+     */
+    ResumableResult<void>
+    writeOpMode(RegOpMode_t opMode);
+
+    ResumableResult<void>
+    setCarrierFreq(uint8_t msb, uint8_t mid, uint8_t lsb);
+
+    ResumableResult<void>
+    setCarrierFreq(frequency_t freq);
+
+    ResumableResult<void>
+    setPaBoost();
+
+    ResumableResult<void>
+    setOutputPower(uint8_t power);
+
+    ResumableResult<void>
+    setBandwidth(SignalBandwidth bw);
+
+    ResumableResult<void>
+    setCodingRate(ErrorCodingRate cr);
+
+    ResumableResult<void>
+    setSpreadingFactor(SpreadingFactor sf);
+
+    ResumableResult<void>
+    setImplicitHeaderMode();
+
+    ResumableResult<void>
+    setExplicitHeaderMode();
+
+    ResumableResult<void>
+    setDio0Mapping(uint8_t map);
+
+    ResumableResult<void>
+    enablePayloadCRC();
+
+    ResumableResult<void>
+    setPayloadLength(uint8_t len);
+
+    ResumableResult<bool>
+    getInterrupt(RegIrqFlags irq);
+
+    // -- Send/Receive ---------------------------------------------------------
+    ResumableResult<void>
+    getPayload(uint8_t *data, uint8_t nbBytes);
+
+    ResumableResult<void>
+    sendPacket(uint8_t *data, uint8_t nbBytes);
+
+    /**
+     *  Writes a packet to the Fifo without starting the transmission.
+     *
+     *  Also sets the payload length. Loading another packet before
+     *  startTransmit() replaces the previous one.
+     */
+    ResumableResult<void>
+    loadPacket(const uint8_t *data, uint8_t nbBytes);
+
+    /// Transmits the packet previously written by loadPacket()
+    ResumableResult<void>
+    startTransmit();
+
+    // -- Observer -------------------------------------------------------------
+
+    /// Reports OpMode, PaConfig and interrupt flags to `observer`, `nullptr` disables it
+    void
+    setObserver(SX127xObserver *observer);
+
+    /**
+     *  Changes whenever sleep mode is written, which clears the Fifo.
+     *
+     *  Lets helpers that keep a packet in the Fifo detect its loss.
+     */
+    uint8_t
+    getFifoEpoch() const;
+
+protected:
+    // SX127xAsync accesses the registers itself but reports like the core
+    friend class SX127xAsync;
+
+    void
+    recordOpMode(RegOpMode_t opMode);
+
+    void
+    recordPaConfig(RegPaConfig_t paConfig);
+
+    void
+    recordIrqFlags(RegIrqFlags_t irqFlags);
+
+    RegAccess_t regAccess;
+
+private:
+    uint8_t value;
+
+    SX127xObserver *observer;
+    uint8_t fifoEpoch;
+
+    union Shadow {
+        RegOpMode_t regOpMode;
+        RegPaConfig_t regPaConfig;
+        RegLna_t regLna;
+        RegIrqFlagsMask_t regIrqFlagsMask;
+        RegIrqFlags_t regIrqFlags;
+        RegModemConfig1_t regModemConfig1;
+        RegModemConfig2_t regModemConfig2;
+        RegModemConfig3_t regModemConfig3;
+        RegDioMapping1_t regDioMapping1;
+        Frf frf;
+
+        Shadow() {this->regOpMode.value = 0x00;}
+    } shadow;
+};
+}
+
+#endif
@@ -48,17 +48,43 @@ public:
         RxNbBytes = 0x13,
         RegPktSnrValue = 0x19,
         RegPktRssiValue = 0x1a,
+        RssiValue = 0x1b,
         HopChannel = 0x1c,
         ModemConfig1 = 0x1d,
         ModemConfig2 = 0x1e,
         ModemConfig3 = 0x26,
         PayloadLength = 0x22,
+        SyncWord = 0x39,
         DioMapping1 = 0x40
     };
     typedef Configuration<RegAccess_t, Address, 0x7F> Address_t;
 
     // -- Common Registers -----------------------------------------------------
 
+    /// Register content of RegFrfMsb, RegFrfMid and RegFrfLsb (MSB first)
+    struct Frf
+    {
+        uint8_t value[3];
+    };
+
+    /**
+     *  Converts a carrier frequency to its register representation.
+     *
+     *  Intended to precompute channel tables at compile time, so that
+     *  retuning costs a single burst write instead of a float conversion.
+     *
+     *  @param freq Carrier frequency in Hz.
+     */
+    static constexpr Frf
+    toFrf(uint32_t freq)
+    {
+        // Frf = freq * 2^19 / F(XOSC) with F(XOSC) = 32 MHz
+        const uint32_t frf = static_cast<uint32_t>((static_cast<uint64_t>(freq) << 19) / 32000000ul);
+        return {{static_cast<uint8_t>((frf >> 16) & 0xFF),
+                 static_cast<uint8_t>((frf >> 8) & 0xFF),
+                 static_cast<uint8_t>(frf & 0xFF)}};
+    }
+
     // -- Operation Mode Register
     enum class
     RegOpMode : uint8_t
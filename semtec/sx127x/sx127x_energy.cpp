@@ -0,0 +1,296 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "sx127x_energy.hpp"
+
+namespace modm
+{
+
+SX127xEnergyMeter::SX127xEnergyMeter(const CurrentTable &table) :
+    table(table), state(State::Sleep), opMode(), opModeKnown(false),
+    paBoost(false), outputPower(0)
+{
+    reset();
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xEnergyMeter::onOpMode(sx127x::RegOpMode_t opMode)
+{
+    const sx127x::Mode mode = sx127x::Mode_t::get(opMode);
+    const bool changed = not opModeKnown or mode != sx127x::Mode_t::get(this->opMode);
+
+    // e.g. setLowFrequencyMode() rewrites the same mode
+    this->opMode = opMode;
+    opModeKnown = true;
+    if (changed) {
+        transition(mode);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xEnergyMeter::onPaConfig(sx127x::RegPaConfig_t paConfig)
+{
+    // Account the running transmission with the previous setting
+    update();
+
+    paBoost = paConfig & sx127x::RegPaConfig::PaSelect;
+    outputPower = sx127x::OutputPower_t::get(paConfig);
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xEnergyMeter::onIrqFlags(sx127x::RegIrqFlags_t flags)
+{
+    if (not opModeKnown) {
+        return;
+    }
+
+    bool standby = false;
+    switch (sx127x::Mode_t::get(opMode))
+    {
+        case sx127x::Mode::Transmit:
+            standby = flags & sx127x::RegIrqFlags::TxDone;
+            break;
+        case sx127x::Mode::RecvSingle:
+            standby = (flags & sx127x::RegIrqFlags::RxDone) or
+                      (flags & sx127x::RegIrqFlags::RxTimeout);
+            break;
+        case sx127x::Mode::ChnActvDetect:
+            standby = flags & sx127x::RegIrqFlags::CadDone;
+            break;
+        default:
+            break;
+    }
+
+    if (standby)
+    {
+        sx127x::Mode_t::set(opMode, sx127x::Mode::Standby);
+        transition(sx127x::Mode::Standby);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xEnergyMeter::transition(sx127x::Mode mode)
+{
+    update();
+
+    switch (mode)
+    {
+        case sx127x::Mode::Sleep:
+            state = State::Sleep;
+            break;
+        case sx127x::Mode::Standby:
+            state = State::Standby;
+            break;
+        case sx127x::Mode::FreqSynthTX:
+        case sx127x::Mode::FreqSynthRX:
+            state = State::Synth;
+            break;
+        case sx127x::Mode::Transmit:
+            state = State::Tx;
+            break;
+        case sx127x::Mode::RecvCont:
+        case sx127x::Mode::RecvSingle:
+            state = State::Rx;
+            break;
+        case sx127x::Mode::ChnActvDetect:
+            state = State::Cad;
+            break;
+    }
+
+    lastTransition = lastUpdate;
+    transitions++;
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xEnergyMeter::update()
+{
+    const PreciseClock::time_point now = PreciseClock::now();
+    const PreciseClock::duration elapsed = now - lastUpdate;
+
+    time[static_cast<uint8_t>(state)] += elapsed.count();
+    charge += static_cast<uint64_t>(getCurrent()) * static_cast<uint64_t>(elapsed.count());
+
+    lastUpdate = now;
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xEnergyMeter::reset()
+{
+    lastUpdate = PreciseClock::now();
+    lastTransition = lastUpdate;
+    transitions = 0;
+    charge = 0;
+
+    for (uint64_t &t : time) {
+        t = 0;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xEnergyMeter::State
+SX127xEnergyMeter::getState() const
+{
+    return state;
+}
+
+// ----------------------------------------------------------------------------
+
+bool
+SX127xEnergyMeter::isOpModeKnown() const
+{
+    return opModeKnown;
+}
+
+// ----------------------------------------------------------------------------
+
+sx127x::RegOpMode_t
+SX127xEnergyMeter::getOpMode() const
+{
+    return opMode;
+}
+
+// ----------------------------------------------------------------------------
+
+PreciseClock::time_point
+SX127xEnergyMeter::getLastTransition() const
+{
+    return lastTransition;
+}
+
+// ----------------------------------------------------------------------------
+
+uint32_t
+SX127xEnergyMeter::getTransitions() const
+{
+    return transitions;
+}
+
+// ----------------------------------------------------------------------------
+
+uint64_t
+SX127xEnergyMeter::getTime(State state) const
+{
+    return time[static_cast<uint8_t>(state)];
+}
+
+// ----------------------------------------------------------------------------
+
+uint64_t
+SX127xEnergyMeter::getCharge() const
+{
+    return charge / 1000000ull;
+}
+
+// ----------------------------------------------------------------------------
+
+uint32_t
+SX127xEnergyMeter::getCurrent() const
+{
+    switch (state)
+    {
+        case State::Sleep:   return table.sleep;
+        case State::Standby: return table.standby;
+        case State::Synth:   return table.synth;
+        case State::Rx:      return table.rx;
+        case State::Cad:     return table.cad;
+        case State::Tx:
+            return paBoost ? table.txPaBoost[outputPower] : table.txRfo[outputPower];
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+
+SX127xPowerManager::SX127xPowerManager(SX127xCore &radio, SX127xEnergyMeter &meter,
+                                       PreciseClock::duration idleTimeout) :
+    radio(radio), meter(meter), idleTimeout(idleTimeout), opMode()
+{
+
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xPowerManager::setIdleTimeout(PreciseClock::duration timeout)
+{
+    idleTimeout = timeout;
+}
+
+// ----------------------------------------------------------------------------
+
+bool
+SX127xPowerManager::isSleeping() const
+{
+    return meter.getState() == SX127xEnergyMeter::State::Sleep;
+}
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xPowerManager::update()
+{
+    RF_BEGIN();
+
+    meter.update();
+
+    if (meter.getState() != SX127xEnergyMeter::State::Standby or
+        PreciseClock::now() - meter.getLastTransition() < idleTimeout)
+    {
+        RF_RETURN();
+    }
+
+    if (meter.isOpModeKnown())
+    {
+        // The meter follows every OpMode write, no read-modify-write necessary
+        opMode = meter.getOpMode();
+        sx127x::Mode_t::set(opMode, sx127x::Mode::Sleep);
+        RF_CALL(radio.writeOpMode(opMode));
+    }
+    else {
+        RF_CALL(radio.setOperationMode(sx127x::Mode::Sleep));
+    }
+
+    RF_END();
+}
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xPowerManager::resume()
+{
+    RF_BEGIN();
+
+    if (not isSleeping()) {
+        RF_RETURN();
+    }
+
+    if (meter.isOpModeKnown())
+    {
+        opMode = meter.getOpMode();
+        sx127x::Mode_t::set(opMode, sx127x::Mode::Standby);
+        RF_CALL(radio.writeOpMode(opMode));
+    }
+    else {
+        RF_CALL(radio.setOperationMode(sx127x::Mode::Standby));
+    }
+
+    RF_END();
+}
+
+} // end namespace modm
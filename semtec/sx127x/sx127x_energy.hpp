@@ -0,0 +1,169 @@
+#ifndef SX127X_ENERGY_HPP
+#define SX127X_ENERGY_HPP
+
+#include <modm/architecture/interface/clock.hpp>
+#include <modm/processing/resumable.hpp>
+
+#include "sx127x_core.hpp"
+
+namespace modm
+{
+
+/**
+ *  Integrates the time and charge a SX127x spends in each power state.
+ *
+ *  Attach it with SX127xCore::setObserver(), the driver then reports every
+ *  OpMode and PA setting. The transmit current is looked up per PA output
+ *  and OutputPower setting.
+ *
+ *  The automatic return to standby after TxDone, RxDone/RxTimeout in
+ *  single receive mode and CadDone is accounted when getInterrupt() reads
+ *  the flag, so the time in the previous state is overestimated by at most
+ *  the interrupt polling interval.
+ *
+ *  PreciseClock wraps around after 71.6 minutes, update() has to be called
+ *  at least every MaxUpdateInterval to account the elapsed time correctly,
+ *  e.g. through SX127xPowerManager::update(). The totals do not wrap.
+ */
+class SX127xEnergyMeter : public SX127xObserver
+{
+public:
+    enum class
+    State : uint8_t
+    {
+        Sleep = 0,
+        Standby,
+        Synth,
+        Tx,
+        Rx,
+        Cad
+    };
+    static constexpr uint8_t States = 6;
+
+    /// Longest time between two calls of update(), in µs
+    static constexpr uint32_t MaxUpdateInterval = 3600000000ul;
+
+    /// Supply current in µA of each state
+    struct CurrentTable
+    {
+        uint32_t sleep;
+        uint32_t standby;
+        uint32_t synth;
+        uint32_t rx;
+        uint32_t cad;
+        /// Indexed by OutputPower, RFO output
+        uint32_t txRfo[16];
+        /// Indexed by OutputPower, PA_BOOST output
+        uint32_t txPaBoost[16];
+    };
+
+public:
+    explicit SX127xEnergyMeter(const CurrentTable &table);
+
+    void
+    onOpMode(sx127x::RegOpMode_t opMode) override;
+
+    void
+    onPaConfig(sx127x::RegPaConfig_t paConfig) override;
+
+    void
+    onIrqFlags(sx127x::RegIrqFlags_t flags) override;
+
+    /// Integrates the current state up to now
+    void
+    update();
+
+    void
+    reset();
+
+    State
+    getState() const;
+
+    /// Whether an OpMode write has been observed since construction
+    bool
+    isOpModeKnown() const;
+
+    /// OpMode register content, including automatic returns to standby
+    sx127x::RegOpMode_t
+    getOpMode() const;
+
+    /// Time of the last mode change, writes of the same mode do not count
+    PreciseClock::time_point
+    getLastTransition() const;
+
+    uint32_t
+    getTransitions() const;
+
+    /// Accumulated time in µs
+    uint64_t
+    getTime(State state) const;
+
+    /// Accumulated charge in µC
+    uint64_t
+    getCharge() const;
+
+private:
+    void
+    transition(sx127x::Mode mode);
+
+    uint32_t
+    getCurrent() const;
+
+    const CurrentTable &table;
+
+    State state;
+    sx127x::RegOpMode_t opMode;
+    bool opModeKnown;
+    bool paBoost;
+    uint8_t outputPower;
+
+    PreciseClock::time_point lastUpdate;
+    PreciseClock::time_point lastTransition;
+    uint32_t transitions;
+    /// Accumulated time in µs
+    uint64_t time[States];
+    /// Accumulated charge in µA * µs
+    uint64_t charge;
+};
+
+/**
+ *  Puts an idle radio to sleep and wakes it up again.
+ *
+ *  update() drops the radio from standby to sleep once it has not changed
+ *  its mode for the idle timeout. resume() returns to standby. update()
+ *  also integrates the meter, calling it at least every
+ *  SX127xEnergyMeter::MaxUpdateInterval, also while the radio sleeps,
+ *  keeps the energy accounting correct. Both take
+ *  the OpMode register content from the meter, which has to observe the
+ *  radio, and cost a single register write once the driver has written
+ *  OpMode. The Fifo content is lost in sleep mode, all other registers are
+ *  retained.
+ */
+class SX127xPowerManager : protected NestedResumable<1>
+{
+public:
+    SX127xPowerManager(SX127xCore &radio, SX127xEnergyMeter &meter,
+                       PreciseClock::duration idleTimeout);
+
+    void
+    setIdleTimeout(PreciseClock::duration timeout);
+
+    bool
+    isSleeping() const;
+
+    ResumableResult<void>
+    update();
+
+    ResumableResult<void>
+    resume();
+
+private:
+    SX127xCore &radio;
+    SX127xEnergyMeter &meter;
+    PreciseClock::duration idleTimeout;
+    sx127x::RegOpMode_t opMode;
+};
+
+}
+
+#endif
@@ -0,0 +1,220 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include <string.h>
+
+#include "sx127x_fec.hpp"
+
+namespace
+{
+
+// Exponent and logarithm tables of GF(2^8) with the polynomial
+// x^8 + x^4 + x^3 + x^2 + 1 (0x11d). The exponent table is doubled, so
+// that log[a] + log[b] never has to be reduced.
+struct GaloisTables
+{
+    uint8_t exp[512];
+    uint8_t log[256];
+
+    constexpr GaloisTables() : exp(), log()
+    {
+        uint16_t x = 1;
+        for (uint16_t ii = 0; ii < 255; ii++)
+        {
+            exp[ii] = static_cast<uint8_t>(x);
+            exp[ii + 255] = static_cast<uint8_t>(x);
+            log[x] = static_cast<uint8_t>(ii);
+
+            x <<= 1;
+            if (x & 0x100) {
+                x ^= 0x11d;
+            }
+        }
+        exp[510] = exp[0];
+        exp[511] = exp[1];
+    }
+};
+
+constexpr GaloisTables gf;
+
+}
+
+namespace modm
+{
+
+uint8_t
+SX127xFecCodec::multiply(uint8_t a, uint8_t b)
+{
+    if (a == 0 or b == 0) {
+        return 0;
+    }
+    return gf.exp[gf.log[a] + gf.log[b]];
+}
+
+// ----------------------------------------------------------------------------
+
+uint8_t
+SX127xFecCodec::inverse(uint8_t a)
+{
+    return gf.exp[255 - gf.log[a]];
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xFecCodec::multiplyAdd(uint8_t *dst, const uint8_t *src, uint8_t c, uint16_t nbBytes)
+{
+    if (c == 0) {
+        return;
+    }
+
+    if (c == 1)
+    {
+        for (; nbBytes >= 4; nbBytes -= 4, dst += 4, src += 4)
+        {
+            uint32_t s, d;
+            memcpy(&s, src, 4);
+            memcpy(&d, dst, 4);
+            d ^= s;
+            memcpy(dst, &d, 4);
+        }
+        for (; nbBytes > 0; nbBytes--) {
+            *dst++ ^= *src++;
+        }
+        return;
+    }
+
+    // c * x = c * (x & 0x0f) ^ c * (x & 0xf0)
+    uint8_t low[16];
+    uint8_t high[16];
+    for (uint8_t ii = 0; ii < 16; ii++)
+    {
+        low[ii] = multiply(c, ii);
+        high[ii] = multiply(c, static_cast<uint8_t>(ii << 4));
+    }
+
+    for (; nbBytes >= 4; nbBytes -= 4, dst += 4, src += 4)
+    {
+        uint32_t s, d;
+        memcpy(&s, src, 4);
+        memcpy(&d, dst, 4);
+        for (uint8_t shift = 0; shift < 32; shift += 8)
+        {
+            const uint8_t x = static_cast<uint8_t>(s >> shift);
+            d ^= static_cast<uint32_t>(low[x & 0x0f] ^ high[x >> 4]) << shift;
+        }
+        memcpy(dst, &d, 4);
+    }
+    for (; nbBytes > 0; nbBytes--, dst++, src++) {
+        *dst ^= low[*src & 0x0f] ^ high[*src >> 4];
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xFecCodec::scale(uint8_t *buffer, uint8_t c, uint16_t nbBytes)
+{
+    if (c == 1) {
+        return;
+    }
+
+    for (; nbBytes > 0; nbBytes--, buffer++) {
+        *buffer = multiply(c, *buffer);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xFecCodec::encode(uint8_t *fragments, uint8_t k, uint8_t m, uint16_t size)
+{
+    for (uint8_t jj = 0; jj < m; jj++)
+    {
+        uint8_t *parity = fragments + (k + jj) * size;
+        memset(parity, 0, size);
+
+        for (uint8_t ii = 0; ii < k; ii++) {
+            multiplyAdd(parity, fragments + ii * size, coefficient(k, jj, ii), size);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool
+SX127xFecCodec::decode(uint8_t *fragments, uint32_t present, uint8_t k, uint8_t m,
+                       uint16_t size, uint8_t *matrix)
+{
+    // Collect the missing data fragments and as many parity fragments
+    uint8_t missing[32];
+    uint8_t parity[32];
+    uint8_t erasures = 0;
+    uint8_t available = 0;
+
+    for (uint8_t ii = 0; ii < k; ii++)
+    {
+        if (not (present & (1ul << ii))) {
+            missing[erasures++] = ii;
+        }
+    }
+    for (uint8_t jj = 0; jj < m and available < erasures; jj++)
+    {
+        if (present & (1ul << (k + jj))) {
+            parity[available++] = jj;
+        }
+    }
+    if (available < erasures) {
+        return false;
+    }
+
+    // Move each chosen parity fragment into a missing slot and subtract the
+    // contribution of the received data fragments.
+    for (uint8_t rr = 0; rr < erasures; rr++)
+    {
+        uint8_t *row = fragments + missing[rr] * size;
+        memcpy(row, fragments + (k + parity[rr]) * size, size);
+
+        for (uint8_t ii = 0; ii < k; ii++)
+        {
+            if (present & (1ul << ii)) {
+                multiplyAdd(row, fragments + ii * size, coefficient(k, parity[rr], ii), size);
+            }
+        }
+        for (uint8_t cc = 0; cc < erasures; cc++) {
+            matrix[rr * erasures + cc] = coefficient(k, parity[rr], missing[cc]);
+        }
+    }
+
+    // Gauss-Jordan elimination. Every square submatrix of a Cauchy matrix is
+    // regular, so all pivots are non-zero and no row exchange is needed.
+    for (uint8_t cc = 0; cc < erasures; cc++)
+    {
+        uint8_t *pivotRow = fragments + missing[cc] * size;
+        const uint8_t factor = inverse(matrix[cc * erasures + cc]);
+
+        for (uint8_t ii = 0; ii < erasures; ii++) {
+            matrix[cc * erasures + ii] = multiply(matrix[cc * erasures + ii], factor);
+        }
+        scale(pivotRow, factor, size);
+
+        for (uint8_t rr = 0; rr < erasures; rr++)
+        {
+            const uint8_t c = matrix[rr * erasures + cc];
+            if (rr == cc or c == 0) {
+                continue;
+            }
+            for (uint8_t ii = 0; ii < erasures; ii++) {
+                matrix[rr * erasures + ii] ^= multiply(c, matrix[cc * erasures + ii]);
+            }
+            multiplyAdd(fragments + missing[rr] * size, pivotRow, c, size);
+        }
+    }
+
+    return true;
+}
+
+} // end namespace modm
@@ -0,0 +1,124 @@
+#ifndef SX127X_FEC_HPP
+#define SX127X_FEC_HPP
+
+#include <stdint.h>
+
+namespace modm
+{
+
+/**
+ *  Reed-Solomon erasure code over GF(2^8) for multi-frame messages.
+ *
+ *  K data fragments are extended by M parity fragments using a systematic
+ *  Cauchy matrix, any K of the K + M fragments restore the message. All
+ *  fragments are stored back to back with a stride of `size` bytes.
+ *  Multiplications are table driven and applied a word at a time.
+ */
+class SX127xFecCodec
+{
+public:
+    static uint8_t
+    multiply(uint8_t a, uint8_t b);
+
+    static uint8_t
+    inverse(uint8_t a);
+
+    /// Encoding matrix entry of parity fragment `parity` for data fragment `data`
+    static uint8_t
+    coefficient(uint8_t k, uint8_t parity, uint8_t data)
+    { return inverse(static_cast<uint8_t>((k + parity) ^ data)); }
+
+    /// dst[i] ^= c * src[i]
+    static void
+    multiplyAdd(uint8_t *dst, const uint8_t *src, uint8_t c, uint16_t nbBytes);
+
+    /// buffer[i] = c * buffer[i]
+    static void
+    scale(uint8_t *buffer, uint8_t c, uint16_t nbBytes);
+
+    /// Computes fragments k..k+m-1 from fragments 0..k-1
+    static void
+    encode(uint8_t *fragments, uint8_t k, uint8_t m, uint16_t size);
+
+    /**
+     *  Restores the missing data fragments in place.
+     *
+     *  @param present Bit i is set if fragment i has been received.
+     *  @param matrix  Workspace of at least m * m bytes.
+     *  @return `false` if less than k fragments are present.
+     */
+    static bool
+    decode(uint8_t *fragments, uint32_t present, uint8_t k, uint8_t m,
+           uint16_t size, uint8_t *matrix);
+};
+
+/**
+ *  Message buffer applying SX127xFecCodec to sendPacket()/getPayload().
+ *
+ *  Every frame carries a two byte header (message id, fragment index)
+ *  followed by one fragment, so lost frames of a message are recovered
+ *  from the parity frames without retransmission.
+ *
+ *  @tparam K    Number of data fragments.
+ *  @tparam M    Number of parity fragments.
+ *  @tparam Size Number of bytes per fragment.
+ */
+template <uint8_t K, uint8_t M, uint8_t Size>
+class SX127xFec
+{
+    static_assert(K > 0 and K + M <= 32, "At most 32 fragments per message are supported");
+    static_assert(Size <= 255 - 2, "A frame of header and fragment exceeds 255 bytes");
+
+public:
+    static constexpr uint8_t Fragments = K + M;
+    static constexpr uint8_t HeaderSize = 2;
+    static constexpr uint8_t FrameSize = HeaderSize + Size;
+    static constexpr uint16_t MessageSize = K * Size;
+
+    SX127xFec();
+
+    /// Message buffer of MessageSize bytes
+    uint8_t*
+    getMessage();
+
+    /// Computes the parity fragments of the message in getMessage()
+    void
+    encode(uint8_t message);
+
+    /**
+     *  Builds the frame of fragment `index` to pass to sendPacket().
+     *
+     *  @param frame Buffer of at least FrameSize bytes.
+     *  @return Number of bytes written to `frame`, 0 if `index` is not
+     *          less than Fragments.
+     */
+    uint8_t
+    getFrame(uint8_t index, uint8_t *frame) const;
+
+    /**
+     *  Stores a received frame, a new message id discards the previous one.
+     *
+     *  Frames of a message that has already been decoded are ignored until
+     *  a frame with another id arrives, so message ids only have to differ
+     *  between consecutive messages.
+     *
+     *  @return `true` for the frame that completed and decoded the message.
+     */
+    bool
+    putFrame(const uint8_t *frame, uint8_t nbBytes);
+
+    bool
+    isComplete() const;
+
+private:
+    uint8_t fragments[Fragments][Size];
+    uint8_t matrix[M * M + 1];
+    uint32_t received;
+    uint8_t message;
+    bool complete;
+};
+}
+
+#include "sx127x_fec_impl.hpp"
+
+#endif
@@ -0,0 +1,97 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include <string.h>
+
+namespace modm
+{
+
+template <uint8_t K, uint8_t M, uint8_t Size>
+SX127xFec<K, M, Size>::SX127xFec() :
+    received(0), message(0), complete(false)
+{
+
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t K, uint8_t M, uint8_t Size>
+uint8_t*
+SX127xFec<K, M, Size>::getMessage()
+{
+    return fragments[0];
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t K, uint8_t M, uint8_t Size>
+void
+SX127xFec<K, M, Size>::encode(uint8_t message)
+{
+    this->message = message;
+    SX127xFecCodec::encode(fragments[0], K, M, Size);
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t K, uint8_t M, uint8_t Size>
+uint8_t
+SX127xFec<K, M, Size>::getFrame(uint8_t index, uint8_t *frame) const
+{
+    if (index >= Fragments) {
+        return 0;
+    }
+
+    frame[0] = message;
+    frame[1] = index;
+    memcpy(frame + HeaderSize, fragments[index], Size);
+
+    return FrameSize;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t K, uint8_t M, uint8_t Size>
+bool
+SX127xFec<K, M, Size>::putFrame(const uint8_t *frame, uint8_t nbBytes)
+{
+    if (nbBytes != FrameSize or frame[1] >= Fragments) {
+        return false;
+    }
+
+    if (frame[0] != message or received == 0)
+    {
+        message = frame[0];
+        received = 0;
+        complete = false;
+    }
+
+    // Remaining frames of the decoded message
+    if (complete) {
+        return false;
+    }
+
+    memcpy(fragments[frame[1]], frame + HeaderSize, Size);
+    received |= (1ul << frame[1]);
+
+    // Decode as soon as any K fragments are there
+    if (static_cast<uint8_t>(__builtin_popcountl(received)) >= K) {
+        complete = SX127xFecCodec::decode(fragments[0], received, K, M, Size, matrix);
+    }
+
+    return complete;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t K, uint8_t M, uint8_t Size>
+bool
+SX127xFec<K, M, Size>::isComplete() const
+{
+    return complete;
+}
+
+} // end namespace modm
@@ -0,0 +1,66 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "sx127x_scanner.hpp"
+
+namespace modm
+{
+
+SX127xScanner::SX127xScanner(SX127xCore &radio) :
+    radio(radio), opMode(), previous(), channel(0), sample(0), value(0)
+{
+
+}
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xScanner::scan(const Frf *channels, uint8_t nbChannels,
+                    uint8_t nbSamples, uint8_t *histogram,
+                    std::chrono::microseconds settle)
+{
+    RF_BEGIN();
+
+    // Read OpMode once, all following mode changes are plain writes
+    RF_CALL(radio.read(Address::OpMode, &(opMode.value), 1));
+    RF_CALL(radio.read(Address::FrMsb, previous.value, 3));
+
+    for (channel = 0; channel < nbChannels; channel++)
+    {
+        // Frf may only be changed in sleep or standby mode
+        Mode_t::set(opMode, Mode::Standby);
+        RF_CALL(radio.writeOpMode(opMode));
+
+        // write the three frequency bytes (MSB->LSB) in one burst
+        RF_CALL(radio.write(Address::FrMsb, channels[channel].value, 3));
+
+        Mode_t::set(opMode, Mode::RecvCont);
+        RF_CALL(radio.writeOpMode(opMode));
+
+        timeout.restart(settle);
+        RF_WAIT_UNTIL(timeout.isExpired());
+
+        histogram[channel] = 0;
+        for (sample = 0; sample < nbSamples; sample++)
+        {
+            RF_CALL(radio.read(Address::RssiValue, &(value), 1));
+
+            if (value > histogram[channel]) {
+                histogram[channel] = value;
+            }
+        }
+    }
+
+    Mode_t::set(opMode, Mode::Standby);
+    RF_CALL(radio.writeOpMode(opMode));
+
+    // Tune back to the carrier frequency the radio was configured for
+    RF_CALL(radio.write(Address::FrMsb, previous.value, 3));
+
+    RF_END();
+};
+
+} // end namespace modm
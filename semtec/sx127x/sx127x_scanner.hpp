@@ -0,0 +1,58 @@
+#ifndef SX127X_SCANNER_HPP
+#define SX127X_SCANNER_HPP
+
+#include <modm/processing/resumable.hpp>
+#include <modm/processing/timer.hpp>
+
+#include "sx127x_core.hpp"
+
+namespace modm
+{
+
+/**
+ *  Channel occupancy scanner for a SX127x radio.
+ *
+ *  Retunes by writing the precomputed Frf bytes of each channel in one
+ *  burst, enters continuous receive mode and samples the live RSSI
+ *  register back to back.
+ */
+class SX127xScanner : public sx127x, protected NestedResumable<1>
+{
+public:
+    SX127xScanner(SX127xCore &radio);
+
+    /**
+     *  Measures the channel occupancy of a table of carrier frequencies.
+     *
+     *  Samples the live RSSI register `nbSamples` times per channel after
+     *  `settle` has passed and stores the peak raw value of each channel in
+     *  `histogram[channel]`; RSSI[dBm] = -157 + value (HF port) or
+     *  -164 + value (LF port). Afterwards the radio is tuned back to the
+     *  carrier frequency it had before and left in standby mode.
+     *
+     *  The module has to be in LoRa mode already.
+     *
+     *  @param channels   Table of precomputed carrier frequencies, see toFrf().
+     *  @param nbChannels Number of entries in `channels` and `histogram`.
+     *  @param nbSamples  Number of RSSI samples taken per channel.
+     *  @param histogram  Caller provided result buffer.
+     *  @param settle     Time to wait for PLL lock and RSSI settling.
+     */
+    ResumableResult<void>
+    scan(const Frf *channels, uint8_t nbChannels, uint8_t nbSamples,
+         uint8_t *histogram,
+         std::chrono::microseconds settle = std::chrono::microseconds(250));
+
+private:
+    SX127xCore &radio;
+
+    RegOpMode_t opMode;
+    Frf previous;
+    uint8_t channel;
+    uint8_t sample;
+    uint8_t value;
+    ShortPreciseTimeout timeout;
+};
+}
+
+#endif
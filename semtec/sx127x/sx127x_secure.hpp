@@ -0,0 +1,176 @@
+#ifndef SX127X_SECURE_HPP
+#define SX127X_SECURE_HPP
+
+#include <modm/processing/resumable.hpp>
+
+#include "sx127x_aes.hpp"
+#include "sx127x_core.hpp"
+
+namespace modm
+{
+
+/**
+ *  AES-CCM (RFC 3610) with a length field of two bytes.
+ *
+ *  Encrypts, decrypts and authenticates in place, the payload may be fed
+ *  in chunks; all chunks but the last must be a multiple of 16 bytes.
+ *
+ *  @tparam Aes     Block cipher backend, e.g. SX127xAesSoftware.
+ *  @tparam MicSize Length of the message integrity code (4, 6, ..., 16).
+ */
+template <typename Aes, uint8_t MicSize = 4>
+class SX127xCcm
+{
+    static_assert(MicSize >= 4 and MicSize <= 16 and MicSize % 2 == 0, "Invalid MIC size");
+
+public:
+    static constexpr uint8_t BlockSize = 16;
+    static constexpr uint8_t NonceSize = 13;
+
+    void
+    setKey(const uint8_t *key);
+
+    /// Starts a message, `aadLength` is limited to 14 bytes
+    void
+    begin(const uint8_t *nonce, const uint8_t *aad, uint8_t aadLength, uint16_t length);
+
+    void
+    encrypt(uint8_t *data, uint8_t nbBytes);
+
+    void
+    decrypt(uint8_t *data, uint8_t nbBytes);
+
+    /// Writes the encrypted MIC of MicSize bytes
+    void
+    finish(uint8_t *mic);
+
+    /// Compares `mic` against the MIC of the decrypted message
+    bool
+    verify(const uint8_t *mic);
+
+private:
+    void
+    authenticate(const uint8_t *data, uint8_t nbBytes);
+
+    void
+    applyKeystream(uint8_t *data, uint8_t nbBytes);
+
+    Aes aes;
+    uint8_t tag[BlockSize];
+    uint8_t counter[BlockSize];
+    uint16_t block;
+};
+
+/**
+ *  Encrypted and authenticated point-to-point link on top of a SX127x.
+ *
+ *  Frames are sent as `sender id, frame counter (LE32), ciphertext, MIC`.
+ *  The payload is encrypted in place while it is streamed into the Fifo
+ *  and decrypted in place while it is read, so no second buffer is
+ *  needed. Only frames with the sender id of the peer are accepted, they
+ *  are checked against a sliding window of the last 32 frame counters of
+ *  the peer to reject replays.
+ *
+ *  The frame counter must never repeat under the same key, restore it with
+ *  setTxCounter() after a reset.
+ *
+ *  @tparam Aes Block cipher backend, selected at compile time.
+ */
+template <typename Aes = SX127xAesSoftware>
+class SX127xSecureLink : protected NestedResumable<1>
+{
+public:
+    static constexpr uint8_t HeaderSize = 5;
+    static constexpr uint8_t MicSize = 4;
+    static constexpr uint8_t Overhead = HeaderSize + MicSize;
+    static constexpr uint8_t ReplayWindow = 32;
+
+public:
+    /**
+     *  @param nodeId Sender id of the own frames.
+     *  @param peerId Sender id of the frames accepted by receive().
+     */
+    SX127xSecureLink(SX127xCore &radio, uint8_t nodeId, uint8_t peerId);
+
+    /// Sets the 16 byte AES-128 key
+    void
+    setKey(const uint8_t *key);
+
+    void
+    setTxCounter(uint32_t counter);
+
+    uint32_t
+    getTxCounter() const;
+
+    /// Number of frames rejected as replayed
+    uint32_t
+    getReplayDrops() const;
+
+    /// Number of frames rejected due to a wrong MIC
+    uint32_t
+    getAuthFailures() const;
+
+    /// Number of frames rejected due to a sender id other than the peer's
+    uint32_t
+    getForeignDrops() const;
+
+    /// Number of frames rejected as shorter than Overhead or too long for the buffer
+    uint32_t
+    getLengthErrors() const;
+
+    /**
+     *  Encrypts `data` in place, loads it into the Fifo and transmits it.
+     *
+     *  @param nbBytes At most 255 - Overhead bytes.
+     *  @return `false` if `nbBytes` is too long, nothing is sent then.
+     */
+    ResumableResult<bool>
+    send(uint8_t *data, uint8_t nbBytes);
+
+    /**
+     *  Reads, decrypts and verifies a received frame after RxDone.
+     *
+     *  @return Number of plaintext bytes in `data`, 0 if the frame was
+     *          rejected.
+     */
+    ResumableResult<uint8_t>
+    receive(uint8_t *data, uint8_t maxBytes);
+
+private:
+    void
+    makeNonce(uint8_t sender, uint32_t frameCounter);
+
+    bool
+    isReplay(uint32_t frameCounter) const;
+
+    void
+    acceptCounter(uint32_t frameCounter);
+
+    SX127xCore &radio;
+    SX127xCcm<Aes, MicSize> ccm;
+    const uint8_t nodeId;
+    const uint8_t peerId;
+
+    uint32_t txCounter;
+    uint32_t rxCounter;
+    uint32_t rxWindow;
+    bool rxValid;
+
+    uint32_t replayDrops;
+    uint32_t authFailures;
+    uint32_t foreignDrops;
+    uint32_t lengthErrors;
+
+    uint8_t header[HeaderSize];
+    uint8_t mic[MicSize];
+    uint8_t nonce[SX127xCcm<Aes, MicSize>::NonceSize];
+    uint8_t length;
+    uint8_t offset;
+    uint8_t chunk;
+    bool accepted;
+};
+}
+
+#include "sx127x_secure_impl.hpp"
+
+#endif
@@ -0,0 +1,383 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include <string.h>
+
+namespace modm
+{
+
+template <typename Aes, uint8_t MicSize>
+void
+SX127xCcm<Aes, MicSize>::setKey(const uint8_t *key)
+{
+    aes.setKey(key);
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes, uint8_t MicSize>
+void
+SX127xCcm<Aes, MicSize>::begin(const uint8_t *nonce, const uint8_t *aad,
+                               uint8_t aadLength, uint16_t length)
+{
+    // B0: Flags | Nonce | l(m), with L = 2
+    tag[0] = (aadLength ? 0x40 : 0x00) | (((MicSize - 2) / 2) << 3) | 0x01;
+    memcpy(tag + 1, nonce, NonceSize);
+    tag[14] = static_cast<uint8_t>(length >> 8);
+    tag[15] = static_cast<uint8_t>(length);
+    aes.encrypt(tag);
+
+    if (aadLength)
+    {
+        uint8_t first[BlockSize] = {};
+        first[1] = aadLength;
+        memcpy(first + 2, aad, aadLength);
+        authenticate(first, BlockSize);
+    }
+
+    // A_i: Flags | Nonce | i
+    counter[0] = 0x01;
+    memcpy(counter + 1, nonce, NonceSize);
+    block = 1;
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes, uint8_t MicSize>
+void
+SX127xCcm<Aes, MicSize>::encrypt(uint8_t *data, uint8_t nbBytes)
+{
+    for (uint16_t ii = 0; ii < nbBytes; ii += BlockSize)
+    {
+        const uint8_t size = (nbBytes - ii < BlockSize) ? (nbBytes - ii) : BlockSize;
+        authenticate(data + ii, size);
+        applyKeystream(data + ii, size);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes, uint8_t MicSize>
+void
+SX127xCcm<Aes, MicSize>::decrypt(uint8_t *data, uint8_t nbBytes)
+{
+    for (uint16_t ii = 0; ii < nbBytes; ii += BlockSize)
+    {
+        const uint8_t size = (nbBytes - ii < BlockSize) ? (nbBytes - ii) : BlockSize;
+        applyKeystream(data + ii, size);
+        authenticate(data + ii, size);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes, uint8_t MicSize>
+void
+SX127xCcm<Aes, MicSize>::finish(uint8_t *mic)
+{
+    uint8_t stream[BlockSize];
+
+    memcpy(stream, counter, BlockSize);
+    stream[14] = 0;
+    stream[15] = 0;
+    aes.encrypt(stream);
+
+    for (uint8_t ii = 0; ii < MicSize; ii++) {
+        mic[ii] = tag[ii] ^ stream[ii];
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes, uint8_t MicSize>
+bool
+SX127xCcm<Aes, MicSize>::verify(const uint8_t *mic)
+{
+    uint8_t expected[MicSize];
+    finish(expected);
+
+    // constant time comparison
+    uint8_t difference = 0;
+    for (uint8_t ii = 0; ii < MicSize; ii++) {
+        difference |= expected[ii] ^ mic[ii];
+    }
+    return difference == 0;
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes, uint8_t MicSize>
+void
+SX127xCcm<Aes, MicSize>::authenticate(const uint8_t *data, uint8_t nbBytes)
+{
+    // CBC-MAC, a short block is padded with zeros
+    for (uint8_t ii = 0; ii < nbBytes; ii++) {
+        tag[ii] ^= data[ii];
+    }
+    aes.encrypt(tag);
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes, uint8_t MicSize>
+void
+SX127xCcm<Aes, MicSize>::applyKeystream(uint8_t *data, uint8_t nbBytes)
+{
+    uint8_t stream[BlockSize];
+
+    counter[14] = static_cast<uint8_t>(block >> 8);
+    counter[15] = static_cast<uint8_t>(block);
+    block++;
+
+    memcpy(stream, counter, BlockSize);
+    aes.encrypt(stream);
+
+    for (uint8_t ii = 0; ii < nbBytes; ii++) {
+        data[ii] ^= stream[ii];
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+SX127xSecureLink<Aes>::SX127xSecureLink(SX127xCore &radio, uint8_t nodeId, uint8_t peerId) :
+    radio(radio), nodeId(nodeId), peerId(peerId), txCounter(0), rxCounter(0),
+    rxWindow(0), rxValid(false), replayDrops(0), authFailures(0), foreignDrops(0),
+    lengthErrors(0)
+{
+
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+void
+SX127xSecureLink<Aes>::setKey(const uint8_t *key)
+{
+    ccm.setKey(key);
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+void
+SX127xSecureLink<Aes>::setTxCounter(uint32_t counter)
+{
+    txCounter = counter;
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+uint32_t
+SX127xSecureLink<Aes>::getTxCounter() const
+{
+    return txCounter;
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+uint32_t
+SX127xSecureLink<Aes>::getReplayDrops() const
+{
+    return replayDrops;
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+uint32_t
+SX127xSecureLink<Aes>::getAuthFailures() const
+{
+    return authFailures;
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+uint32_t
+SX127xSecureLink<Aes>::getForeignDrops() const
+{
+    return foreignDrops;
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+uint32_t
+SX127xSecureLink<Aes>::getLengthErrors() const
+{
+    return lengthErrors;
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+void
+SX127xSecureLink<Aes>::makeNonce(uint8_t sender, uint32_t frameCounter)
+{
+    memset(nonce, 0, sizeof(nonce));
+    nonce[0] = sender;
+    nonce[1] = static_cast<uint8_t>(frameCounter);
+    nonce[2] = static_cast<uint8_t>(frameCounter >> 8);
+    nonce[3] = static_cast<uint8_t>(frameCounter >> 16);
+    nonce[4] = static_cast<uint8_t>(frameCounter >> 24);
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+bool
+SX127xSecureLink<Aes>::isReplay(uint32_t frameCounter) const
+{
+    if (not rxValid or frameCounter > rxCounter) {
+        return false;
+    }
+
+    const uint32_t age = rxCounter - frameCounter;
+    return age >= ReplayWindow or (rxWindow & (1ul << age));
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+void
+SX127xSecureLink<Aes>::acceptCounter(uint32_t frameCounter)
+{
+    if (not rxValid or frameCounter > rxCounter)
+    {
+        const uint32_t shift = frameCounter - rxCounter;
+        rxWindow = (not rxValid or shift >= ReplayWindow) ? 0 : (rxWindow << shift);
+        rxWindow |= 1;
+        rxCounter = frameCounter;
+        rxValid = true;
+    }
+    else {
+        rxWindow |= (1ul << (rxCounter - frameCounter));
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+ResumableResult<bool>
+SX127xSecureLink<Aes>::send(uint8_t *data, uint8_t nbBytes)
+{
+    RF_BEGIN();
+
+    if (nbBytes > 255 - Overhead) {
+        RF_RETURN(false);
+    }
+
+    header[0] = nodeId;
+    header[1] = static_cast<uint8_t>(txCounter);
+    header[2] = static_cast<uint8_t>(txCounter >> 8);
+    header[3] = static_cast<uint8_t>(txCounter >> 16);
+    header[4] = static_cast<uint8_t>(txCounter >> 24);
+
+    makeNonce(nodeId, txCounter);
+    txCounter++;
+
+    // The header is authenticated, but sent in clear
+    ccm.begin(nonce, header, HeaderSize, nbBytes);
+    RF_CALL(radio.loadPacket(header, HeaderSize));
+
+    // Encrypt block by block while streaming into the Fifo
+    for (offset = 0; offset < nbBytes; offset += chunk)
+    {
+        chunk = (nbBytes - offset < 16) ? (nbBytes - offset) : 16;
+        ccm.encrypt(data + offset, chunk);
+        RF_CALL(radio.write(sx127x::Address::Fifo, data + offset, chunk));
+    }
+
+    ccm.finish(mic);
+    RF_CALL(radio.write(sx127x::Address::Fifo, mic, MicSize));
+
+    RF_CALL(radio.setPayloadLength(nbBytes + Overhead));
+    RF_CALL(radio.startTransmit());
+
+    RF_END_RETURN(true);
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename Aes>
+ResumableResult<uint8_t>
+SX127xSecureLink<Aes>::receive(uint8_t *data, uint8_t maxBytes)
+{
+    RF_BEGIN();
+
+    // Clear RxDone interrupt flag
+    RF_CALL(radio.write(sx127x::Address::IrqFlags, (uint8_t) sx127x::RegIrqFlags::RxDone));
+
+    RF_CALL(radio.read(sx127x::Address::RxNbBytes, &length, 1));
+
+    // Set Fifo address pointer to payload address
+    RF_CALL(radio.read(sx127x::Address::FifoRxCurrAddr, &offset, 1));
+    RF_CALL(radio.write(sx127x::Address::FifoAddrPtr, offset));
+
+    accepted = false;
+    if (length >= Overhead and length - Overhead <= maxBytes)
+    {
+        RF_CALL(radio.read(sx127x::Address::Fifo, header, HeaderSize));
+        length -= Overhead;
+
+        {
+            const uint32_t frameCounter = header[1] | (uint32_t(header[2]) << 8) |
+                    (uint32_t(header[3]) << 16) | (uint32_t(header[4]) << 24);
+            if (header[0] != peerId) {
+                foreignDrops++;
+                length = 0;
+            }
+            else if (isReplay(frameCounter)) {
+                replayDrops++;
+                length = 0;
+            }
+            else {
+                makeNonce(header[0], frameCounter);
+                ccm.begin(nonce, header, HeaderSize, length);
+            }
+        }
+
+        // Decrypt block by block while draining the Fifo
+        for (offset = 0; offset < length; offset += chunk)
+        {
+            chunk = (length - offset < 16) ? (length - offset) : 16;
+            RF_CALL(radio.read(sx127x::Address::Fifo, data + offset, chunk));
+            ccm.decrypt(data + offset, chunk);
+        }
+
+        if (length > 0)
+        {
+            RF_CALL(radio.read(sx127x::Address::Fifo, mic, MicSize));
+
+            if (ccm.verify(mic))
+            {
+                acceptCounter(nonce[1] | (uint32_t(nonce[2]) << 8) |
+                        (uint32_t(nonce[3]) << 16) | (uint32_t(nonce[4]) << 24));
+                accepted = true;
+            }
+            else
+            {
+                // Never hand out unauthenticated plaintext
+                memset(data, 0, length);
+                authFailures++;
+            }
+        }
+    }
+    else {
+        lengthErrors++;
+    }
+
+    // Reset Fifo address pointer
+    RF_CALL(radio.read(sx127x::Address::FifoRxBaseAddr, &offset, 1));
+    RF_CALL(radio.write(sx127x::Address::FifoAddrPtr, offset));
+
+    RF_END_RETURN(accepted ? length : uint8_t(0));
+}
+
+} // end namespace modm
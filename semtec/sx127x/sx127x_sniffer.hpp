@@ -0,0 +1,118 @@
+#ifndef SX127X_SNIFFER_HPP
+#define SX127X_SNIFFER_HPP
+
+#include <atomic>
+#include <stddef.h>
+
+#include <modm/architecture/interface/clock.hpp>
+#include <modm/processing/resumable.hpp>
+
+#include "sx127x_core.hpp"
+
+namespace modm
+{
+
+/**
+ *  Promiscuous packet capture with pcap (LoRaTap) export.
+ *
+ *  update() is the producer: on RxDone it stores the frame together with
+ *  timestamp, SNR, RSSI, CRC status and the radio settings of the last
+ *  start() directly into the next free slot of a lock-free
+ *  single-producer/single-consumer ring. If the consumer falls behind the
+ *  frame is dropped and counted, the radio is never blocked. The consumer
+ *  may run in another context and drains the ring with front()/pop() or
+ *  exportPcap().
+ *
+ *  @tparam Depth Number of ring slots, a power of two.
+ *  @tparam Mtu   Maximum stored payload size, longer frames are truncated.
+ */
+template <uint8_t Depth, uint8_t Mtu = 255>
+class SX127xSniffer : protected NestedResumable<1>
+{
+    static_assert(Depth > 0 and (Depth & (Depth - 1)) == 0, "Depth must be a power of two");
+
+public:
+    struct Capture
+    {
+        /// Reception time in milliseconds
+        uint32_t timestamp;
+        /// Carrier frequency in Hz
+        uint32_t frequency;
+        /// Packet SNR in 0.25 dB steps (RegPktSnrValue)
+        int8_t snr;
+        /// Raw packet RSSI (RegPktRssiValue)
+        uint8_t rssi;
+        bool crcError;
+        /// Bandwidth in 125 kHz steps as in LoRaTap, 0 below 125 kHz
+        uint8_t bandwidth;
+        uint8_t spreadingFactor;
+        uint8_t syncWord;
+        /// Length of the frame on air
+        uint8_t length;
+        uint8_t data[Mtu];
+    };
+
+    static constexpr size_t PcapHeaderSize = 24;
+    static constexpr size_t PcapRecordHeaderSize = 16;
+    static constexpr size_t LoraTapHeaderSize = 15;
+
+public:
+    SX127xSniffer(SX127xCore &radio, uint8_t syncWord = 0x12);
+
+    /// Tunes the radio, programs the sync word and enters continuous receive mode
+    ResumableResult<void>
+    start(frequency_t frequency, sx127x::SignalBandwidth bandwidth,
+          sx127x::SpreadingFactor spreadingFactor);
+
+    /// Captures a received frame, call periodically or on DIO0
+    ResumableResult<void>
+    update();
+
+    /// Number of frames dropped because the ring was full
+    uint32_t
+    getDropped() const;
+
+    // -- Consumer -------------------------------------------------------------
+
+    /// @return oldest capture or `nullptr` if the ring is empty
+    const Capture*
+    front() const;
+
+    void
+    pop();
+
+    /// Writes the pcap file header of PcapHeaderSize bytes
+    static size_t
+    writePcapHeader(uint8_t *out);
+
+    /**
+     *  Writes the oldest capture as pcap record with LoRaTap header and
+     *  removes it from the ring.
+     *
+     *  @return Number of bytes written, 0 if the ring is empty or `size`
+     *          is too small for the record.
+     */
+    size_t
+    exportPcap(uint8_t *out, size_t size);
+
+private:
+    SX127xCore &radio;
+    Capture ring[Depth];
+    std::atomic<uint16_t> head;
+    std::atomic<uint16_t> tail;
+    std::atomic<uint32_t> dropped;
+
+    uint32_t frequency;
+    uint8_t bandwidth;
+    uint8_t spreadingFactor;
+    const uint8_t syncWord;
+
+    sx127x::RegIrqFlags_t flags;
+    uint8_t packet[2];
+    Capture *slot;
+};
+}
+
+#include "sx127x_sniffer_impl.hpp"
+
+#endif
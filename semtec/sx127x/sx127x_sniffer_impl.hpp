@@ -0,0 +1,225 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include <string.h>
+
+namespace modm
+{
+
+namespace sx127x_sniffer
+{
+
+inline uint8_t*
+putLe32(uint8_t *out, uint32_t value)
+{
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    out[2] = static_cast<uint8_t>(value >> 16);
+    out[3] = static_cast<uint8_t>(value >> 24);
+    return out + 4;
+}
+
+inline uint8_t*
+putBe32(uint8_t *out, uint32_t value)
+{
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+    return out + 4;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+SX127xSniffer<Depth, Mtu>::SX127xSniffer(SX127xCore &radio, uint8_t syncWord) :
+    radio(radio), head(0), tail(0), dropped(0), frequency(0), bandwidth(0),
+    spreadingFactor(0), syncWord(syncWord)
+{
+
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+ResumableResult<void>
+SX127xSniffer<Depth, Mtu>::start(frequency_t frequency, sx127x::SignalBandwidth bandwidth,
+                                 sx127x::SpreadingFactor spreadingFactor)
+{
+    RF_BEGIN();
+
+    this->frequency = frequency;
+    this->spreadingFactor = static_cast<uint8_t>(spreadingFactor);
+
+    // LoRaTap encodes the bandwidth in 125 kHz steps
+    switch (bandwidth)
+    {
+        case sx127x::SignalBandwidth::Fr125kHz: this->bandwidth = 1; break;
+        case sx127x::SignalBandwidth::Fr250kHz: this->bandwidth = 2; break;
+        case sx127x::SignalBandwidth::Fr500kHz: this->bandwidth = 4; break;
+        default: this->bandwidth = 0; break;
+    }
+
+    RF_CALL(radio.setCarrierFreq(frequency));
+    RF_CALL(radio.setBandwidth(bandwidth));
+    RF_CALL(radio.setSpreadingFactor(spreadingFactor));
+    RF_CALL(radio.write(sx127x::Address::SyncWord, syncWord));
+    RF_CALL(radio.setOperationMode(sx127x::Mode::RecvCont));
+
+    RF_END();
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+ResumableResult<void>
+SX127xSniffer<Depth, Mtu>::update()
+{
+    RF_BEGIN();
+
+    RF_CALL(radio.read(sx127x::Address::IrqFlags, &(flags.value), 1));
+
+    if (not (flags & sx127x::RegIrqFlags::RxDone)) {
+        RF_RETURN();
+    }
+
+    // getPayload() clears RxDone, the CRC error flag is cleared here
+    if (flags & sx127x::RegIrqFlags::PayloadCrcError) {
+        RF_CALL(radio.write(sx127x::Address::IrqFlags, (uint8_t) sx127x::RegIrqFlags::PayloadCrcError));
+    }
+
+    if (static_cast<uint16_t>(head.load(std::memory_order_relaxed) -
+                              tail.load(std::memory_order_acquire)) >= Depth)
+    {
+        // Only the producer writes it, so no read-modify-write is needed,
+        // which ARMv6-M only has in libatomic
+        dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        RF_CALL(radio.write(sx127x::Address::IrqFlags, (uint8_t) sx127x::RegIrqFlags::RxDone));
+        RF_RETURN();
+    }
+
+    slot = &ring[head.load(std::memory_order_relaxed) % Depth];
+    slot->timestamp = Clock::now().time_since_epoch().count();
+    slot->frequency = frequency;
+    slot->bandwidth = bandwidth;
+    slot->spreadingFactor = spreadingFactor;
+    slot->syncWord = syncWord;
+    slot->crcError = bool(flags & sx127x::RegIrqFlags::PayloadCrcError);
+
+    // RegPktSnrValue and RegPktRssiValue are adjacent
+    RF_CALL(radio.read(sx127x::Address::RegPktSnrValue, packet, 2));
+    slot->snr = static_cast<int8_t>(packet[0]);
+    slot->rssi = packet[1];
+
+    RF_CALL(radio.read(sx127x::Address::RxNbBytes, &(slot->length), 1));
+
+    // Read the frame straight into the ring slot
+    RF_CALL(radio.getPayload(slot->data, (slot->length < Mtu) ? slot->length : Mtu));
+
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+
+    RF_END();
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+uint32_t
+SX127xSniffer<Depth, Mtu>::getDropped() const
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+const typename SX127xSniffer<Depth, Mtu>::Capture*
+SX127xSniffer<Depth, Mtu>::front() const
+{
+    const uint16_t index = tail.load(std::memory_order_relaxed);
+
+    if (head.load(std::memory_order_acquire) == index) {
+        return nullptr;
+    }
+    return &ring[index % Depth];
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+void
+SX127xSniffer<Depth, Mtu>::pop()
+{
+    tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+size_t
+SX127xSniffer<Depth, Mtu>::writePcapHeader(uint8_t *out)
+{
+    out = sx127x_sniffer::putLe32(out, 0xa1b2c3d4);    // magic number
+    *out++ = 2; *out++ = 0;                             // version major
+    *out++ = 4; *out++ = 0;                             // version minor
+    out = sx127x_sniffer::putLe32(out, 0);              // GMT offset
+    out = sx127x_sniffer::putLe32(out, 0);              // timestamp accuracy
+    out = sx127x_sniffer::putLe32(out, 65535);          // snapshot length
+    sx127x_sniffer::putLe32(out, 270);                  // LINKTYPE_LORATAP
+
+    return PcapHeaderSize;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+size_t
+SX127xSniffer<Depth, Mtu>::exportPcap(uint8_t *out, size_t size)
+{
+    const Capture *capture = front();
+    if (capture == nullptr) {
+        return 0;
+    }
+
+    const uint8_t stored = (capture->length < Mtu) ? capture->length : Mtu;
+    const size_t record = PcapRecordHeaderSize + LoraTapHeaderSize + stored;
+    if (size < record) {
+        return 0;
+    }
+
+    // pcap record header
+    out = sx127x_sniffer::putLe32(out, capture->timestamp / 1000);
+    out = sx127x_sniffer::putLe32(out, (capture->timestamp % 1000) * 1000);
+    out = sx127x_sniffer::putLe32(out, LoraTapHeaderSize + stored);
+    out = sx127x_sniffer::putLe32(out, LoraTapHeaderSize + capture->length);
+
+    // LoRaTap v0 header, RSSI[dBm] = -139 + value. The packet RSSI offset
+    // is -157 dBm on the HF port and -164 dBm on the LF port.
+    const uint8_t offset = (capture->frequency < 525000000ul) ? 25 : 18;
+    const uint8_t rssi = (capture->rssi > offset) ? (capture->rssi - offset) : 0;
+
+    *out++ = 0;                                         // version
+    *out++ = 0;                                         // padding
+    *out++ = 0; *out++ = LoraTapHeaderSize;             // length (BE)
+    out = sx127x_sniffer::putBe32(out, capture->frequency);
+    *out++ = capture->bandwidth;
+    *out++ = capture->spreadingFactor;
+    *out++ = rssi;                                      // packet RSSI
+    *out++ = rssi;                                      // max RSSI
+    *out++ = 0;                                         // current RSSI
+    *out++ = static_cast<uint8_t>(capture->snr);
+    *out++ = capture->syncWord;
+
+    memcpy(out, capture->data, stored);
+
+    pop();
+
+    return record;
+}
+
+} // end namespace modm
@@ -0,0 +1,120 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "sx127x_task.hpp"
+
+static_assert(modm::SX127xFramePool::Blocks <= 32, "The block bitmap has 32 bits");
+
+namespace modm
+{
+
+alignas(max_align_t) uint8_t SX127xFramePool::storage[Blocks][BlockSize];
+uint32_t SX127xFramePool::used = 0;
+uint8_t SX127xFramePool::peak = 0;
+size_t SX127xFramePool::largest = 0;
+uint32_t SX127xFramePool::failures = 0;
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+size_t
+blockCount(size_t size)
+{
+    return (size + SX127xFramePool::BlockSize - 1) / SX127xFramePool::BlockSize;
+}
+
+uint32_t
+blockMask(size_t blocks)
+{
+    return blocks < 32 ? (1ul << blocks) - 1 : 0xfffffffful;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+
+void*
+SX127xFramePool::allocate(size_t size) noexcept
+{
+    if (size > largest) {
+        largest = size;
+    }
+
+    const size_t blocks = blockCount(size);
+    if (blocks <= Blocks)
+    {
+        const uint32_t mask = blockMask(blocks);
+        for (uint8_t ii = 0; ii + blocks <= Blocks; ii++)
+        {
+            if (not (used & (mask << ii)))
+            {
+                used |= (mask << ii);
+                if (getInUse() > peak) {
+                    peak = getInUse();
+                }
+                return storage[ii];
+            }
+        }
+    }
+
+    failures++;
+    return nullptr;
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xFramePool::deallocate(void *frame, size_t size) noexcept
+{
+    const size_t index = (static_cast<uint8_t*>(frame) - storage[0]) / BlockSize;
+    used &= ~(blockMask(blockCount(size)) << index);
+}
+
+// ----------------------------------------------------------------------------
+
+uint8_t
+SX127xFramePool::getInUse()
+{
+    return static_cast<uint8_t>(__builtin_popcountl(used));
+}
+
+// ----------------------------------------------------------------------------
+
+uint8_t
+SX127xFramePool::getPeak()
+{
+    return peak;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t
+SX127xFramePool::getLargestFrame()
+{
+    return largest;
+}
+
+// ----------------------------------------------------------------------------
+
+uint32_t
+SX127xFramePool::getFailures()
+{
+    return failures;
+}
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xFramePool::resetStatistics()
+{
+    peak = getInUse();
+    largest = 0;
+    failures = 0;
+}
+
+} // end namespace modm
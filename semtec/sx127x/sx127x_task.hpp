@@ -0,0 +1,292 @@
+#ifndef SX127X_TASK_HPP
+#define SX127X_TASK_HPP
+
+#include <coroutine>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+
+#include <modm/processing/resumable.hpp>
+
+namespace modm
+{
+
+/// Operation a suspended SX127xTask waits for, poll() returns `true` while running
+class SX127xPollable
+{
+public:
+    virtual bool
+    poll() = 0;
+};
+
+/**
+ *  Fixed block allocator of the SX127xTask coroutine frames.
+ *
+ *  Frames never come from the heap. A frame takes as many contiguous blocks
+ *  as it needs, most operations of SX127xAsync take one. If there are not
+ *  enough contiguous free blocks, the coroutine call returns an invalid
+ *  task, see SX127xTask::isValid(). Only use tasks from one context, the
+ *  pool is not interrupt safe.
+ */
+class SX127xFramePool
+{
+public:
+    static constexpr uint8_t Blocks = 16;
+    static constexpr size_t BlockSize = 16 * sizeof(void*);
+
+    /// @return `nullptr` if there are not enough contiguous free blocks
+    static void*
+    allocate(size_t size) noexcept;
+
+    /// Frees the blocks of a frame of `size` bytes
+    static void
+    deallocate(void *frame, size_t size) noexcept;
+
+    /// Number of blocks currently in use
+    static uint8_t
+    getInUse();
+
+    /// Largest number of blocks in use at the same time
+    static uint8_t
+    getPeak();
+
+    /// Largest frame size requested so far
+    static size_t
+    getLargestFrame();
+
+    /// Number of frames that could not be allocated
+    static uint32_t
+    getFailures();
+
+    /// Resets peak, largest frame and failures
+    static void
+    resetStatistics();
+
+private:
+    alignas(max_align_t) static uint8_t storage[Blocks][BlockSize];
+    static uint32_t used;
+    static uint8_t peak;
+    static size_t largest;
+    static uint32_t failures;
+};
+
+/// @cond
+struct SX127xPromiseBase
+{
+    SX127xPollable *pending = nullptr;
+
+    static void*
+    operator new(size_t size) noexcept
+    { return SX127xFramePool::allocate(size); }
+
+    static void
+    operator delete(void *frame, size_t size)
+    { SX127xFramePool::deallocate(frame, size); }
+
+    std::suspend_always
+    initial_suspend() noexcept
+    { return {}; }
+
+    std::suspend_always
+    final_suspend() noexcept
+    { return {}; }
+
+    void
+    unhandled_exception()
+    {}
+};
+
+template <typename T>
+struct SX127xPromise : public SX127xPromiseBase
+{
+    T value;
+
+    void
+    return_value(T v)
+    { value = v; }
+};
+
+template <>
+struct SX127xPromise<void> : public SX127xPromiseBase
+{
+    void
+    return_void()
+    {}
+};
+/// @endcond
+
+/**
+ *  Lazily started C++20 coroutine, driven by polling update().
+ *
+ *  A task can be awaited from another task, the child is then polled
+ *  through its parent. Other awaitables are SX127xResumableAwaiter for
+ *  modm resumable functions and SX127xYield.
+ *
+ *  Coroutine frames are taken from SX127xFramePool. If that fails the
+ *  task is invalid: it never runs and isDone() is `true` right away.
+ */
+template <typename T = void>
+class SX127xTask
+{
+public:
+    struct promise_type : public SX127xPromise<T>
+    {
+        SX127xTask
+        get_return_object()
+        { return SX127xTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+        static SX127xTask
+        get_return_object_on_allocation_failure()
+        { return SX127xTask(nullptr); }
+    };
+
+    class Awaiter : public SX127xPollable
+    {
+    public:
+        explicit Awaiter(SX127xTask &task) : task(task) {}
+
+        bool
+        poll() override
+        { return task.update(); }
+
+        bool
+        await_ready()
+        { return not task.update(); }
+
+        template <typename Promise>
+        void
+        await_suspend(std::coroutine_handle<Promise> handle)
+        { handle.promise().pending = this; }
+
+        T
+        await_resume()
+        { return task.getResult(); }
+
+    private:
+        SX127xTask &task;
+    };
+
+public:
+    SX127xTask(SX127xTask &&other) :
+        handle(std::exchange(other.handle, nullptr))
+    {}
+
+    SX127xTask(const SX127xTask&) = delete;
+
+    SX127xTask&
+    operator = (const SX127xTask&) = delete;
+
+    ~SX127xTask()
+    {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    /// Runs the task until it waits again, @return `true` while running
+    bool
+    update()
+    {
+        if (not handle or handle.done()) {
+            return false;
+        }
+
+        SX127xPromiseBase &promise = handle.promise();
+        if (promise.pending and promise.pending->poll()) {
+            return true;
+        }
+        promise.pending = nullptr;
+
+        handle.resume();
+        return not handle.done();
+    }
+
+    /// `false` if no coroutine frame could be allocated for the task
+    bool
+    isValid() const
+    { return bool(handle); }
+
+    bool
+    isDone() const
+    { return not handle or handle.done(); }
+
+    /// Result of a finished task, a value initialized T for an invalid one
+    T
+    getResult()
+    {
+        if constexpr (not std::is_void_v<T>) {
+            return handle ? handle.promise().value : T();
+        }
+    }
+
+    Awaiter
+    operator co_await() &
+    { return Awaiter(*this); }
+
+    Awaiter
+    operator co_await() &&
+    { return Awaiter(*this); }
+
+private:
+    explicit SX127xTask(std::coroutine_handle<promise_type> handle) :
+        handle(handle)
+    {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/// Awaits a modm resumable function, e.g. `SpiMaster::transfer()`
+template <typename F>
+class SX127xResumableAwaiter : public SX127xPollable
+{
+public:
+    explicit SX127xResumableAwaiter(F function) :
+        function(function), result(this->function())
+    {}
+
+    bool
+    poll() override
+    {
+        result = function();
+        return result.getState() > rf::NestingError;
+    }
+
+    bool
+    await_ready() const
+    { return result.getState() <= rf::NestingError; }
+
+    template <typename Promise>
+    void
+    await_suspend(std::coroutine_handle<Promise> handle)
+    { handle.promise().pending = this; }
+
+    auto
+    await_resume()
+    { return result.getResult(); }
+
+private:
+    F function;
+    decltype(std::declval<F&>()()) result;
+};
+
+/// Suspends the awaiting task until the next update()
+struct SX127xYield
+{
+    bool
+    await_ready() const
+    { return false; }
+
+    template <typename Promise>
+    void
+    await_suspend(std::coroutine_handle<Promise> handle)
+    { handle.promise().pending = nullptr; }
+
+    void
+    await_resume()
+    {}
+};
+
+}
+
+#endif
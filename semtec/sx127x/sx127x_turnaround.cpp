@@ -0,0 +1,85 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include "sx127x_turnaround.hpp"
+
+namespace modm
+{
+
+SX127xTurnaround::SX127xTurnaround(SX127xCore &radio) :
+    radio(radio), opMode(), prepared(false), start(), statistics()
+{
+
+}
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xTurnaround::prepare()
+{
+    RF_BEGIN();
+
+    start = PreciseClock::now();
+    prepared = false;
+
+    RF_CALL(radio.read(Address::OpMode, &(opMode.value), 1));
+
+    Mode_t::set(opMode, Mode::FreqSynthTX);
+
+    RF_CALL(radio.writeOpMode(opMode));
+    prepared = true;
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+ResumableResult<void>
+SX127xTurnaround::transmit()
+{
+    RF_BEGIN();
+
+    if (not prepared)
+    {
+        RF_CALL(radio.startTransmit());
+        RF_RETURN();
+    }
+
+    // The remaining OpMode bits are known, no read-modify-write necessary
+    Mode_t::set(opMode, Mode::Transmit);
+
+    RF_CALL(radio.writeOpMode(opMode));
+    prepared = false;
+
+    statistics.last = PreciseClock::now() - start;
+    if (statistics.count == 0 or statistics.last < statistics.min) {
+        statistics.min = statistics.last;
+    }
+    if (statistics.count == 0 or statistics.last > statistics.max) {
+        statistics.max = statistics.last;
+    }
+    statistics.count++;
+
+    RF_END();
+};
+
+// ----------------------------------------------------------------------------
+
+void
+SX127xTurnaround::cancel()
+{
+    prepared = false;
+}
+
+// ----------------------------------------------------------------------------
+
+const SX127xTurnaround::Statistics&
+SX127xTurnaround::getStatistics() const
+{
+    return statistics;
+}
+
+} // end namespace modm
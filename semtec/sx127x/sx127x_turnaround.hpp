@@ -0,0 +1,66 @@
+#ifndef SX127X_TURNAROUND_HPP
+#define SX127X_TURNAROUND_HPP
+
+#include <modm/architecture/interface/clock.hpp>
+#include <modm/processing/resumable.hpp>
+
+#include "sx127x_core.hpp"
+
+namespace modm
+{
+
+/**
+ *  Fast RX to TX turnaround for a SX127x radio.
+ *
+ *  Write the reply with SX127xCore::loadPacket() in standby mode, the LoRa
+ *  Fifo can only be filled in standby. Then prepare() parks the
+ *  synthesizer in FSTx mode, e.g. until the reply slot begins, and the
+ *  following transmit() enters transmit mode with a single register write
+ *  without waiting for the PLL. It records the time since prepare().
+ */
+class SX127xTurnaround : public sx127x, protected NestedResumable<1>
+{
+public:
+    /// Turnaround times of the prepared transmissions
+    struct Statistics
+    {
+        uint32_t count;
+        PreciseClock::duration last;
+        PreciseClock::duration min;
+        PreciseClock::duration max;
+    };
+
+public:
+    SX127xTurnaround(SX127xCore &radio);
+
+    /// Parks the synthesizer in FSTx mode, call it after loading the packet
+    ResumableResult<void>
+    prepare();
+
+    /**
+     *  Starts the transmission of the loaded packet.
+     *
+     *  Without a preceding prepare() it falls back to
+     *  SX127xCore::startTransmit() and records no turnaround time.
+     */
+    ResumableResult<void>
+    transmit();
+
+    /// Forgets a prepare() after the mode was changed by other means
+    void
+    cancel();
+
+    const Statistics&
+    getStatistics() const;
+
+private:
+    SX127xCore &radio;
+
+    RegOpMode_t opMode;
+    bool prepared;
+    PreciseClock::time_point start;
+    Statistics statistics;
+};
+}
+
+#endif
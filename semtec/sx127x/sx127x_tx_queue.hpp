@@ -0,0 +1,138 @@
+#ifndef SX127X_TX_QUEUE_HPP
+#define SX127X_TX_QUEUE_HPP
+
+#include <modm/architecture/interface/clock.hpp>
+#include <modm/container/queue.hpp>
+#include <modm/processing/resumable.hpp>
+
+#include "sx127x_core.hpp"
+
+namespace modm
+{
+
+/**
+ *  Bounded transmit queue with priority classes for a SX127x radio.
+ *
+ *  Frames are copied into statically allocated per-class queues. update()
+ *  has to be called periodically; it always loads the head of the highest
+ *  non-empty class into the Fifo and starts the transmission once the
+ *  channel is free. A frame stays queued until its transmission has been
+ *  started.
+ *
+ *  The channel is held back by setTxEnabled(false), e.g. while a listen
+ *  before talk check runs, and by the duty cycle hold-off after each
+ *  transmission. Preemption only happens in such a window: a loaded lower
+ *  priority frame is replaced in the Fifo when an urgent frame arrives.
+ *  With the channel free, update() loads and starts a frame in the same
+ *  pass and there is nothing to preempt.
+ *
+ *  The LoRa Fifo can only be filled in standby mode. Before loading or
+ *  starting a frame update() reads OpMode. In another mode it waits until
+ *  the channel is free and then switches to standby, which ends a running
+ *  reception; hold the channel back with setTxEnabled(false) while a
+ *  reception must not be cut off. A loaded frame is lost in sleep mode,
+ *  e.g. by SX127xPowerManager. This is detected by
+ *  SX127xCore::getFifoEpoch() and the OpMode read, the frame is loaded
+ *  again.
+ *
+ *  @tparam Depth Number of frames per priority class.
+ *  @tparam Mtu   Maximum payload size of a frame.
+ */
+template <uint8_t Depth, uint8_t Mtu>
+class SX127xTxQueue : protected NestedResumable<1>
+{
+public:
+    enum class
+    Priority : uint8_t
+    {
+        Urgent = 0,
+        Normal = 1,
+        Low = 2
+    };
+    static constexpr uint8_t Priorities = 3;
+
+    /// Time from push() to the start of the transmission
+    struct Latency
+    {
+        uint32_t count;
+        Clock::duration last;
+        Clock::duration max;
+    };
+
+public:
+    SX127xTxQueue(SX127xCore &radio, bool preemption = true);
+
+    /// @return `false` if the class is full or the frame exceeds the Mtu
+    bool
+    push(Priority priority, const uint8_t *data, uint8_t nbBytes);
+
+    bool
+    isEmpty() const;
+
+    /// Holds back the start of transmissions, loading the Fifo continues
+    void
+    setTxEnabled(bool enabled);
+
+    /**
+     *  Limits the share of time spent transmitting.
+     *
+     *  After each transmission the channel is held back for the measured
+     *  airtime times `(1000 - permille) / permille`, e.g. 10 for the 1%
+     *  limit of most EU868 sub-bands. 1000 (the default) disables it.
+     */
+    void
+    setDutyCycle(uint16_t permille);
+
+    void
+    setPreemption(bool enabled);
+
+    const Latency&
+    getLatency(Priority priority) const;
+
+    /// Number of loaded frames that were replaced by a higher priority one
+    uint32_t
+    getPreemptions() const;
+
+    ResumableResult<void>
+    update();
+
+private:
+    struct Frame
+    {
+        uint8_t data[Mtu];
+        uint8_t length;
+        Clock::time_point enqueued;
+    };
+
+    static constexpr uint8_t None = Priorities;
+
+    uint8_t
+    selectClass() const;
+
+    bool
+    isChannelFree() const;
+
+    SX127xCore &radio;
+    BoundedQueue<Frame, Depth> queues[Priorities];
+    Latency latency[Priorities];
+    uint32_t preemptions;
+
+    uint8_t current;
+    uint8_t loaded;
+    uint8_t fifoEpoch;
+    bool transmitting;
+    bool txEnabled;
+    bool preemption;
+
+    sx127x::RegOpMode_t opMode;
+
+    uint16_t dutyCycle;
+    Clock::time_point txStart;
+    Clock::time_point txEnd;
+    Clock::duration holdOff;
+};
+}
+
+#include "sx127x_tx_queue_impl.hpp"
+
+#endif
@@ -0,0 +1,216 @@
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2021, Lucas Mösch
+ * All Rights Reserved.
+ */
+// ----------------------------------------------------------------------------
+
+#include <string.h>
+
+namespace modm
+{
+
+template <uint8_t Depth, uint8_t Mtu>
+SX127xTxQueue<Depth, Mtu>::SX127xTxQueue(SX127xCore &radio, bool preemption) :
+    radio(radio), latency(), preemptions(0), current(None), loaded(None),
+    // Differs from the radio, so the first load makes sure of standby mode
+    fifoEpoch(radio.getFifoEpoch() - 1), transmitting(false), txEnabled(true),
+    preemption(preemption), opMode(), dutyCycle(1000), txStart(), txEnd(), holdOff(0)
+{
+
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+bool
+SX127xTxQueue<Depth, Mtu>::push(Priority priority, const uint8_t *data, uint8_t nbBytes)
+{
+    auto &queue = queues[static_cast<uint8_t>(priority)];
+
+    if (nbBytes > Mtu or queue.isFull()) {
+        return false;
+    }
+
+    Frame frame;
+    memcpy(frame.data, data, nbBytes);
+    frame.length = nbBytes;
+    frame.enqueued = Clock::now();
+
+    return queue.push(frame);
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+bool
+SX127xTxQueue<Depth, Mtu>::isEmpty() const
+{
+    return selectClass() == None;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+void
+SX127xTxQueue<Depth, Mtu>::setTxEnabled(bool enabled)
+{
+    txEnabled = enabled;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+void
+SX127xTxQueue<Depth, Mtu>::setDutyCycle(uint16_t permille)
+{
+    if (permille == 0) {
+        permille = 1;
+    }
+    dutyCycle = permille < 1000 ? permille : 1000;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+void
+SX127xTxQueue<Depth, Mtu>::setPreemption(bool enabled)
+{
+    preemption = enabled;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+const typename SX127xTxQueue<Depth, Mtu>::Latency&
+SX127xTxQueue<Depth, Mtu>::getLatency(Priority priority) const
+{
+    return latency[static_cast<uint8_t>(priority)];
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+uint32_t
+SX127xTxQueue<Depth, Mtu>::getPreemptions() const
+{
+    return preemptions;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+uint8_t
+SX127xTxQueue<Depth, Mtu>::selectClass() const
+{
+    for (uint8_t ii = 0; ii < Priorities; ii++)
+    {
+        if (not queues[ii].isEmpty()) {
+            return ii;
+        }
+    }
+    return None;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+bool
+SX127xTxQueue<Depth, Mtu>::isChannelFree() const
+{
+    // Elapsed time instead of an end time point, the clock wraps around
+    return txEnabled and Clock::now() - txEnd >= holdOff;
+}
+
+// ----------------------------------------------------------------------------
+
+template <uint8_t Depth, uint8_t Mtu>
+ResumableResult<void>
+SX127xTxQueue<Depth, Mtu>::update()
+{
+    RF_BEGIN();
+
+    // Wait for the running transmission to finish
+    if (transmitting)
+    {
+        if (not RF_CALL(radio.getInterrupt(sx127x::RegIrqFlags::TxDone))) {
+            RF_RETURN();
+        }
+        transmitting = false;
+
+        txEnd = Clock::now();
+        holdOff = (txEnd - txStart) * (1000 - dutyCycle) / dutyCycle;
+    }
+
+    current = selectClass();
+    if (current == None) {
+        RF_RETURN();
+    }
+
+    // Keep a loaded lower priority frame unless preemption is allowed
+    if (loaded != None and loaded != current and not preemption) {
+        current = loaded;
+    }
+
+    // Sleep mode cleared the Fifo since the last load
+    if (fifoEpoch != radio.getFifoEpoch())
+    {
+        fifoEpoch = radio.getFifoEpoch();
+        loaded = None;
+    }
+
+    if (loaded == current and not isChannelFree()) {
+        RF_RETURN();
+    }
+
+    // Loading and starting need standby mode, the application may have
+    // left the radio receiving or asleep
+    RF_CALL(radio.read(sx127x::Address::OpMode, &(opMode.value), 1));
+    if (sx127x::Mode_t::get(opMode) != sx127x::Mode::Standby)
+    {
+        // Only end a reception or sleep to transmit right away
+        if (not isChannelFree()) {
+            RF_RETURN();
+        }
+        if (sx127x::Mode_t::get(opMode) == sx127x::Mode::Sleep) {
+            loaded = None;
+        }
+        sx127x::Mode_t::set(opMode, sx127x::Mode::Standby);
+        RF_CALL(radio.writeOpMode(opMode));
+        fifoEpoch = radio.getFifoEpoch();
+    }
+
+    if (loaded != current)
+    {
+        if (loaded != None) {
+            preemptions++;
+        }
+        RF_CALL(radio.loadPacket(queues[current].get().data, queues[current].get().length));
+        loaded = current;
+    }
+
+    if (not isChannelFree()) {
+        RF_RETURN();
+    }
+
+    // OpMode is known, no read-modify-write necessary
+    sx127x::Mode_t::set(opMode, sx127x::Mode::Transmit);
+    RF_CALL(radio.writeOpMode(opMode));
+    txStart = Clock::now();
+
+    {
+        Latency &stats = latency[loaded];
+        stats.last = Clock::now() - queues[loaded].get().enqueued;
+        if (stats.count == 0 or stats.last > stats.max) {
+            stats.max = stats.last;
+        }
+        stats.count++;
+    }
+
+    queues[loaded].pop();
+    loaded = None;
+    transmitting = true;
+
+    RF_END();
+}
+
+} // end namespace modm